@@ -0,0 +1,87 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+//Counts the heap allocations made through the global operator new.
+//Including this header replaces operator new and delete for the whole program,
+//so only one translation unit may include it (bench.cpp, through Benchmark.h).
+
+//Allocations made so far by the calling thread
+inline long long& allocationCount()
+{
+    static thread_local long long count = 0;
+    return count;
+}
+
+// GCC sees the free below pair up with its own operator new once it inlines them
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size)
+{
+    allocationCount()++;
+    if (void* memory = malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+void operator delete[](void* memory) noexcept
+{
+    free(memory);
+}
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
+void operator delete[](void* memory, size_t) noexcept
+{
+    free(memory);
+}
+//Over aligned allocations (std::pmr::new_delete_resource asks for every block this way)
+void* operator new(size_t size, align_val_t alignment)
+{
+    allocationCount()++;
+    size_t align = static_cast<size_t>(alignment);
+    // aligned_alloc wants a whole number of alignments
+    size_t rounded = ((size > 0 ? size : 1) + align - 1) / align * align;
+    if (void* memory = aligned_alloc(align, rounded)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+void* operator new[](size_t size, align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+void operator delete(void* memory, align_val_t) noexcept
+{
+    free(memory);
+}
+void operator delete[](void* memory, align_val_t) noexcept
+{
+    free(memory);
+}
+void operator delete(void* memory, size_t, align_val_t) noexcept
+{
+    free(memory);
+}
+void operator delete[](void* memory, size_t, align_val_t) noexcept
+{
+    free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
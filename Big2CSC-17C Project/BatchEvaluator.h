@@ -0,0 +1,214 @@
+#ifndef BATCHEVALUATOR_H
+#define BATCHEVALUATOR_H
+#include "HandEvaluator.h"
+#include <array>
+#include <cstdint>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BATCH_EVALUATOR_AVX2 1
+#define BATCH_EVALUATOR_TARGET __attribute__((target("avx2")))
+//The scalar evaluator built again for the popcnt instruction, every call inlined into it
+#define BATCH_EVALUATOR_SSE42_TARGET __attribute__((target("sse4.2,popcnt"), flatten))
+#else
+#define BATCH_EVALUATOR_AVX2 0
+#endif
+using namespace std;
+
+//Order keys (see HandEvaluator::orderKey) of many hands at once.
+//The AVX2 path runs HandEvaluator::evaluate on four hands per instruction:
+//the same popcounts, rank nibble sums and shape key, with the shape table
+//read by a gather and the highest rank found from the float exponent of the
+//rank mask. It is picked at run time when the processor has AVX2. Below that
+//the SSE4.2 tier runs the scalar evaluator compiled for the popcnt
+//instruction (a build without -mpopcnt counts bits in a library call), and
+//without either every hand goes through the plain scalar evaluator. All of
+//them give the same keys.
+class BatchEvaluator
+{
+private:
+    //The shape table widened to 32 bits for the gather
+    static constexpr array<uint32_t, HandEvaluator::SHAPE_COUNT> buildTypeTable()
+    {
+        array<uint32_t, HandEvaluator::SHAPE_COUNT> table = {};
+        for (int key = 0; key < HandEvaluator::SHAPE_COUNT; key++)
+        {
+            table[key] = HandEvaluator::SHAPE_TYPE[key];
+        }
+        return table;
+    }
+    static const array<uint32_t, HandEvaluator::SHAPE_COUNT> TYPE_TABLE;
+
+    //Hand types whose rank comes from the grouped ranks, bit per type (see HandEvaluator::rankFromGroups)
+    static constexpr uint64_t GROUP_RANK_TYPES = (1 << 2) | (1 << 3) | (1 << 4) | (1 << 7) | (1 << 8);
+
+#if BATCH_EVALUATOR_AVX2
+    BATCH_EVALUATOR_TARGET static __m256i popCount(__m256i x);
+    BATCH_EVALUATOR_TARGET static __m256i gatherRanks(__m256i flags);
+#endif
+
+public:
+    //Writes the order key of masks[i] to keys[i] with the fastest path of the processor
+    static void orderKeys(const uint64_t* masks, int count, uint32_t* keys);
+    //The same one hand at a time
+    static void orderKeysScalar(const uint64_t* masks, int count, uint32_t* keys);
+    //True when orderKeys uses AVX2
+    static bool hasAvx2();
+    //True when the processor has SSE4.2 and popcnt
+    static bool hasSse42();
+#if BATCH_EVALUATOR_AVX2
+    //Only call when hasAvx2()
+    BATCH_EVALUATOR_TARGET static void orderKeysAvx2(const uint64_t* masks, int count, uint32_t* keys);
+    //Only call when hasSse42()
+    BATCH_EVALUATOR_SSE42_TARGET static void orderKeysSse42(const uint64_t* masks, int count, uint32_t* keys);
+#endif
+};
+
+inline constexpr array<uint32_t, HandEvaluator::SHAPE_COUNT> BatchEvaluator::TYPE_TABLE = BatchEvaluator::buildTypeTable();
+
+inline bool BatchEvaluator::hasAvx2()
+{
+#if BATCH_EVALUATOR_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+inline bool BatchEvaluator::hasSse42()
+{
+#if BATCH_EVALUATOR_AVX2
+    static const bool supported = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    return supported;
+#else
+    return false;
+#endif
+}
+inline void BatchEvaluator::orderKeys(const uint64_t* masks, int count, uint32_t* keys)
+{
+#if BATCH_EVALUATOR_AVX2
+    if (hasAvx2()) {
+        orderKeysAvx2(masks, count, keys);
+        return;
+    }
+    if (hasSse42()) {
+        orderKeysSse42(masks, count, keys);
+        return;
+    }
+#endif
+    orderKeysScalar(masks, count, keys);
+}
+inline void BatchEvaluator::orderKeysScalar(const uint64_t* masks, int count, uint32_t* keys)
+{
+    for (int i = 0; i < count; i++)
+    {
+        keys[i] = HandEvaluator::orderKey(CardSet(masks[i]));
+    }
+}
+
+#if BATCH_EVALUATOR_AVX2
+inline void BatchEvaluator::orderKeysSse42(const uint64_t* masks, int count, uint32_t* keys)
+{
+    for (int i = 0; i < count; i++)
+    {
+        keys[i] = HandEvaluator::orderKey(CardSet(masks[i]));
+    }
+}
+//Set bits of every 64 bit lane, from a nibble lookup per byte
+inline __m256i BatchEvaluator::popCount(__m256i x)
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(x, lowNibbles));
+    __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), lowNibbles));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+//HandEvaluator::gatherRanks on every lane
+inline __m256i BatchEvaluator::gatherRanks(__m256i flags)
+{
+    __m256i x = _mm256_or_si256(_mm256_or_si256(flags, _mm256_srli_epi64(flags, 3)),
+                                _mm256_or_si256(_mm256_srli_epi64(flags, 6), _mm256_srli_epi64(flags, 9)));
+    __m256i ranks = _mm256_and_si256(x, _mm256_set1_epi64x(0xF));
+    ranks = _mm256_or_si256(ranks, _mm256_and_si256(_mm256_srli_epi64(x, 12), _mm256_set1_epi64x(0xF0)));
+    ranks = _mm256_or_si256(ranks, _mm256_and_si256(_mm256_srli_epi64(x, 24), _mm256_set1_epi64x(0xF00)));
+    return _mm256_or_si256(ranks, _mm256_and_si256(_mm256_srli_epi64(x, 36), _mm256_set1_epi64x(0xF000)));
+}
+inline void BatchEvaluator::orderKeysAvx2(const uint64_t* masks, int count, uint32_t* keys)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i five = _mm256_set1_epi64x(5);
+    const __m256i nibbleLow = _mm256_set1_epi64x(static_cast<long long>(HandEvaluator::NIBBLE_LOW));
+    const __m256i pairBits = _mm256_set1_epi64x(0x5555555555555555LL);
+    const __m256i quadBits = _mm256_set1_epi64x(0x3333333333333333LL);
+    const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + i));
+        __m256i cards = popCount(mask);
+
+        //Highest suit count wins, ties go to the higher suit
+        __m256i bestSuitKey = zero;
+        for (int suit = 0; suit < 4; suit++)
+        {
+            __m256i suited = _mm256_and_si256(mask, _mm256_set1_epi64x(static_cast<long long>(CardSet::SUIT_MASK << suit)));
+            __m256i suitKey = _mm256_or_si256(_mm256_slli_epi64(popCount(suited), 2), _mm256_set1_epi64x(suit));
+            bestSuitKey = _mm256_max_epi32(bestSuitKey, suitKey);
+        }
+        __m256i highestSuit = _mm256_add_epi64(_mm256_and_si256(bestSuitKey, _mm256_set1_epi64x(3)), one);
+        __m256i fiveCards = _mm256_cmpeq_epi64(cards, five);
+        __m256i flush = _mm256_and_si256(fiveCards, _mm256_cmpeq_epi64(_mm256_srli_epi64(bestSuitKey, 2), five));
+
+        //Amount of cards of every rank, one nibble per rank (0-4)
+        __m256i perRank = _mm256_sub_epi64(mask, _mm256_and_si256(_mm256_srli_epi64(mask, 1), pairBits));
+        perRank = _mm256_add_epi64(_mm256_and_si256(perRank, quadBits),
+                                   _mm256_and_si256(_mm256_srli_epi64(perRank, 2), quadBits));
+        __m256i shift1 = _mm256_srli_epi64(perRank, 1);
+        __m256i shift2 = _mm256_srli_epi64(perRank, 2);
+        __m256i distinct = gatherRanks(_mm256_and_si256(_mm256_or_si256(perRank, _mm256_or_si256(shift1, shift2)), nibbleLow));
+        __m256i grouped = gatherRanks(_mm256_and_si256(_mm256_or_si256(shift1, shift2), nibbleLow));
+        __m256i tripled = gatherRanks(_mm256_and_si256(_mm256_or_si256(shift2, _mm256_and_si256(shift1, perRank)), nibbleLow));
+        __m256i quadded = gatherRanks(_mm256_and_si256(shift2, nibbleLow));
+
+        // Five ranks in a row: the rank mask is its lowest bit times 0b11111
+        __m256i lowestRank = _mm256_and_si256(distinct, _mm256_sub_epi64(zero, distinct));
+        __m256i straight = _mm256_and_si256(fiveCards, _mm256_cmpeq_epi64(distinct,
+            _mm256_sub_epi64(_mm256_slli_epi64(lowestRank, 5), lowestRank)));
+        __m256i royal = _mm256_and_si256(straight, _mm256_cmpeq_epi64(lowestRank, _mm256_set1_epi64x(1 << 7)));
+
+        __m256i shape = _mm256_min_epi32(cards, _mm256_set1_epi64x(6));
+        shape = _mm256_or_si256(shape, _mm256_slli_epi64(_mm256_min_epi32(popCount(grouped), _mm256_set1_epi64x(3)),
+                                                         HandEvaluator::KEY_PAIRS_SHIFT));
+        shape = _mm256_or_si256(shape, _mm256_andnot_si256(_mm256_cmpeq_epi64(tripled, zero),
+                                                           _mm256_set1_epi64x(1 << HandEvaluator::KEY_TRIP_SHIFT)));
+        shape = _mm256_or_si256(shape, _mm256_andnot_si256(_mm256_cmpeq_epi64(quadded, zero),
+                                                           _mm256_set1_epi64x(1 << HandEvaluator::KEY_QUAD_SHIFT)));
+        shape = _mm256_or_si256(shape, _mm256_and_si256(flush, _mm256_set1_epi64x(1 << HandEvaluator::KEY_FLUSH_SHIFT)));
+        shape = _mm256_or_si256(shape, _mm256_and_si256(straight, _mm256_set1_epi64x(1 << HandEvaluator::KEY_STRAIGHT_SHIFT)));
+        shape = _mm256_or_si256(shape, _mm256_and_si256(royal, _mm256_set1_epi64x(1 << HandEvaluator::KEY_ROYAL_SHIFT)));
+        __m256i type = _mm256_cvtepu32_epi64(_mm256_i64gather_epi32(
+            reinterpret_cast<const int*>(TYPE_TABLE.data()), shape, 4));
+
+        // The rank mask fits a float exactly, its exponent is the highest rank held
+        __m256i fromGroups = _mm256_cmpeq_epi64(_mm256_and_si256(
+            _mm256_srlv_epi64(_mm256_set1_epi64x(GROUP_RANK_TYPES), type), one), one);
+        __m256i rankMask = _mm256_blendv_epi8(distinct, grouped, fromGroups);
+        __m256i exponent = _mm256_and_si256(_mm256_srli_epi64(_mm256_castps_si256(_mm256_cvtepi32_ps(rankMask)), 23),
+                                            _mm256_set1_epi64x(0xFF));
+        __m256i valid = _mm256_xor_si256(_mm256_cmpeq_epi64(type, zero), _mm256_set1_epi64x(-1));
+        __m256i rank = _mm256_and_si256(valid, _mm256_sub_epi64(exponent, _mm256_set1_epi64x(126)));
+        __m256i suit = _mm256_andnot_si256(_mm256_cmpeq_epi64(mask, zero), highestSuit);
+
+        __m256i key = _mm256_or_si256(_mm256_slli_epi64(type, 12),
+                                      _mm256_slli_epi64(_mm256_min_epi32(cards, _mm256_set1_epi64x(15)), 8));
+        key = _mm256_or_si256(key, _mm256_or_si256(_mm256_slli_epi64(rank, 4), suit));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(keys + i),
+                         _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(key, lowHalves)));
+    }
+    // Every AVX2 processor has popcnt
+    orderKeysSse42(masks + i, count - i, keys + i);
+}
+#endif
+
+#endif
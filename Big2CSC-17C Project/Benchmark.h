@@ -0,0 +1,207 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AllocationCounter.h"
+#include "PerfCounters.h"
+using namespace std;
+
+//Keeps the compiler from optimizing away a value that is never used
+template <class T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+//Timing of one benchmark
+struct BenchmarkResult
+{
+    string name;
+    long long iterations = 0;   //Operations timed
+    double seconds = 0;
+    double nsPerOp = 0;
+    double opsPerSec = 0;
+    double allocsPerOp = 0;     //Heap allocations per operation, counted by AllocationCounter.h
+    PerfSample counters;        //Hardware counters per operation (see PerfCounters.h), where available
+    vector<double> samples;     //ns_per_op of each repetition
+};
+
+//Runs benchmarks until each one has been timed for at least minSeconds and
+//prints one JSON object per line:
+//  {"name":"...","iterations":N,"ns_per_op":X,"ops_per_sec":Y,"allocs_per_op":Z}
+//followed, where the hardware counters can be read, by cycles_per_op,
+//instructions_per_op, ipc, branch_misses_per_op, l1d_misses_per_op and
+//llc_misses_per_op (a counter the machine lacks is left out). With more than
+//one repetition every benchmark is timed that many times over and the line
+//also lists the ns_per_op of each one as ns_per_op_samples.
+class BenchmarkRunner
+{
+private:
+    double minSeconds;          //Per repetition
+    int repeats;
+    string filter;              //Only runs benchmarks whose name contains this
+    vector<BenchmarkResult> results;
+    PerfCounters perf;          //Counts the timed loops only
+
+    BenchmarkResult finish(const string& name, long long iterations, double seconds, long long allocations,
+                           const PerfSample& counters, const vector<double>& samples);
+
+public:
+    BenchmarkRunner(double minSeconds, string filter, int repeats = 1);
+
+    bool selected(const string& name) const { return name.find(filter) != string::npos; }
+
+    //Times op(i) for i = 0, 1, 2 ... (op should cycle through its own inputs)
+    template <class Op>
+    void run(const string& name, Op op);
+
+    //For operations that use up their input: prepare(batch) builds a batch of
+    //batchSize inputs outside the timed region, then op(i) is timed on each of them
+    template <class Prepare, class Op>
+    void runBatched(const string& name, long long batchSize, Prepare prepare, Op op);
+
+    const vector<BenchmarkResult>& getResults() const { return results; }
+};
+
+inline BenchmarkRunner::BenchmarkRunner(double seconds, string nameFilter, int repeatCount)
+    : minSeconds(seconds), repeats(repeatCount), filter(nameFilter)
+{
+    if (!perf.any()) {
+        cerr << "Hardware counters unavailable (" << perf.why() << "), timing only" << endl;
+    }
+}
+inline BenchmarkResult BenchmarkRunner::finish(const string& name, long long iterations, double seconds,
+                                               long long allocations, const PerfSample& counters,
+                                               const vector<double>& samples)
+{
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.seconds = seconds;
+    result.nsPerOp = iterations > 0 ? seconds * 1e9 / iterations : 0;
+    result.opsPerSec = seconds > 0 ? iterations / seconds : 0;
+    result.allocsPerOp = iterations > 0 ? static_cast<double>(allocations) / iterations : 0;
+    for (int i = 0; i < PERF_COUNTERS; i++)
+    {
+        result.counters.valid[i] = counters.valid[i] && iterations > 0;
+        result.counters.values[i] = iterations > 0 ? counters.values[i] / iterations : 0;
+    }
+    result.samples = samples;
+    results.push_back(result);
+
+    cout << "{\"name\":\"" << result.name << "\""
+         << ",\"iterations\":" << result.iterations
+         << ",\"ns_per_op\":" << result.nsPerOp
+         << ",\"ops_per_sec\":" << result.opsPerSec
+         << ",\"allocs_per_op\":" << result.allocsPerOp;
+    const PerfSample& perOp = result.counters;
+    for (int i = 0; i < PERF_COUNTERS; i++)
+    {
+        if (perOp.valid[i]) {
+            cout << ",\"" << PerfCounters::name(static_cast<PerfCounter>(i)) << "_per_op\":" << perOp.values[i];
+        }
+    }
+    int cycles = static_cast<int>(PerfCounter::Cycles);
+    int instructions = static_cast<int>(PerfCounter::Instructions);
+    if (perOp.valid[cycles] && perOp.valid[instructions] && perOp.values[cycles] > 0) {
+        cout << ",\"ipc\":" << perOp.values[instructions] / perOp.values[cycles];
+    }
+    if (samples.size() > 1) {
+        cout << ",\"ns_per_op_samples\":[";
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            cout << (i > 0 ? "," : "") << samples[i];
+        }
+        cout << "]";
+    }
+    cout << "}" << endl;
+    return result;
+}
+template <class Op>
+void BenchmarkRunner::run(const string& name, Op op)
+{
+    if (!selected(name)) {
+        return;
+    }
+    long long index = 0;
+    long long iterations = 0;
+    double seconds = 0;
+    vector<double> samples;
+    samples.reserve(repeats);       //Before the allocation count starts
+    long long allocationsBefore = allocationCount();
+    PerfSample counters;
+    for (int repeat = 0; repeat < repeats; repeat++)
+    {
+        // Grow the batch until one batch takes long enough to time reliably
+        long long batch = 1;
+        long long repeatIterations = 0;
+        double repeatSeconds = 0;
+        while (repeatSeconds < minSeconds)
+        {
+            perf.start();
+            auto start = chrono::steady_clock::now();
+            for (long long i = 0; i < batch; i++)
+            {
+                op(index++);
+            }
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            perf.stop(counters);
+            repeatIterations += batch;
+            repeatSeconds += elapsed;
+            if (elapsed < minSeconds / 10) {
+                batch *= 2;
+            }
+        }
+        iterations += repeatIterations;
+        seconds += repeatSeconds;
+        samples.push_back(repeatSeconds * 1e9 / repeatIterations);
+    }
+    finish(name, iterations, seconds, allocationCount() - allocationsBefore, counters, samples);
+}
+template <class Prepare, class Op>
+void BenchmarkRunner::runBatched(const string& name, long long batchSize, Prepare prepare, Op op)
+{
+    if (!selected(name)) {
+        return;
+    }
+    long long iterations = 0;
+    double seconds = 0;
+    long long allocations = 0;      //Only the timed loops count, not prepare
+    PerfSample counters;
+    vector<double> samples;
+    long long batch = 0;            //Keeps counting across repetitions, so each one gets new inputs
+    for (int repeat = 0; repeat < repeats; repeat++)
+    {
+        long long repeatIterations = 0;
+        double repeatSeconds = 0;
+        for (; repeatSeconds < minSeconds; batch++)
+        {
+            prepare(batch);
+            long long allocationsBefore = allocationCount();
+            perf.start();
+            auto start = chrono::steady_clock::now();
+            for (long long i = 0; i < batchSize; i++)
+            {
+                op(i);
+            }
+            repeatSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            perf.stop(counters);
+            allocations += allocationCount() - allocationsBefore;
+            repeatIterations += batchSize;
+        }
+        iterations += repeatIterations;
+        seconds += repeatSeconds;
+        samples.push_back(repeatSeconds * 1e9 / repeatIterations);
+    }
+    finish(name, iterations, seconds, allocations, counters, samples);
+}
+
+#endif
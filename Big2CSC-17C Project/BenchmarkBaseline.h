@@ -0,0 +1,196 @@
+#ifndef BENCHMARKBASELINE_H
+#define BENCHMARKBASELINE_H
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Benchmark.h"
+using namespace std;
+
+//Saved ns_per_op samples of earlier benchmark runs, by benchmark name. The
+//file is text: the line "big2_bench baseline 1", then one line per benchmark
+//with its name and the ns_per_op of every repetition, separated by spaces.
+typedef map<string, vector<double>> BenchmarkBaseline;
+
+const char* const BASELINE_MAGIC = "big2_bench baseline 1";
+
+//How one benchmark compares with its baseline
+struct BaselineComparison
+{
+    string name;
+    double baselineNs = 0;      //Median ns_per_op of the baseline samples
+    double currentNs = 0;       //... and of this run
+    double change = 0;          //currentNs / baselineNs - 1, positive is slower
+    double p = 1;               //Mann-Whitney p-value of this run being slower
+    bool regressed = false;     //Slower by more than the threshold, and significantly so
+};
+
+//Writes the samples of results to path, throws runtime_error if it cannot
+inline void saveBaseline(const string& path, const vector<BenchmarkResult>& results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("Cannot open baseline file " + path);
+    }
+    out.precision(17);
+    out << BASELINE_MAGIC << '\n';
+    for (const auto& result : results)
+    {
+        out << result.name;
+        for (double sample : result.samples)
+        {
+            out << ' ' << sample;
+        }
+        out << '\n';
+    }
+    out.close();
+    if (!out) {
+        throw runtime_error("Cannot write baseline file " + path);
+    }
+}
+
+//Reads a file written by saveBaseline, throws runtime_error if it is not one
+inline BenchmarkBaseline loadBaseline(const string& path)
+{
+    ifstream in(path);
+    if (!in) {
+        throw runtime_error("Cannot open baseline file " + path);
+    }
+    string line;
+    if (!getline(in, line) || line != BASELINE_MAGIC) {
+        throw runtime_error(path + " is not a big2_bench baseline");
+    }
+    BenchmarkBaseline baseline;
+    while (getline(in, line))
+    {
+        istringstream fields(line);
+        string name;
+        if (!(fields >> name)) continue;
+        vector<double> samples;
+        double sample;
+        while (fields >> sample)
+        {
+            samples.push_back(sample);
+        }
+        if (!fields.eof() || samples.empty()) {
+            throw runtime_error("Bad baseline entry for " + name + " in " + path);
+        }
+        baseline[name] = samples;
+    }
+    return baseline;
+}
+
+inline double median(vector<double> values)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    size_t middle = values.size() / 2;
+    nth_element(values.begin(), values.begin() + middle, values.end());
+    double upper = values[middle];
+    if (values.size() % 2 == 1) {
+        return upper;
+    }
+    return (*max_element(values.begin(), values.begin() + middle) + upper) / 2;
+}
+
+//One sided Mann-Whitney U test: the probability of samples at least this much
+//above the baseline if both came from the same distribution. Exact for small
+//samples without ties, otherwise the normal approximation with tie and
+//continuity correction.
+inline double mannWhitneyGreater(const vector<double>& current, const vector<double>& baseline)
+{
+    int n1 = static_cast<int>(current.size());
+    int n2 = static_cast<int>(baseline.size());
+    if (n1 == 0 || n2 == 0) {
+        return 1;
+    }
+    // U counts the (current, baseline) pairs where current is slower, ties half
+    double u = 0;
+    bool ties = false;
+    for (double c : current)
+    {
+        for (double b : baseline)
+        {
+            u += c > b ? 1 : c == b ? 0.5 : 0;
+            ties = ties || c == b;
+        }
+    }
+    int most = n1 * n2;
+
+    if (!ties && n1 + n2 <= 60) {
+        // The number of orderings with each U are the coefficients of the
+        // Gaussian binomial [n1 + n2 choose n1](q) = prod (1 - q^(n2+k)) / (1 - q^k)
+        vector<double> ways(most + 1, 0);
+        ways[0] = 1;
+        for (int k = 1; k <= n1; k++)
+        {
+            for (int v = most; v >= n2 + k; v--)
+            {
+                ways[v] -= ways[v - n2 - k];
+            }
+            for (int v = k; v <= most; v++)
+            {
+                ways[v] += ways[v - k];
+            }
+        }
+        double all = 0;
+        double atLeast = 0;
+        for (int v = 0; v <= most; v++)
+        {
+            all += ways[v];
+            atLeast += v >= u ? ways[v] : 0;
+        }
+        return atLeast / all;
+    }
+
+    vector<double> pooled(current);
+    pooled.insert(pooled.end(), baseline.begin(), baseline.end());
+    sort(pooled.begin(), pooled.end());
+    double tieSum = 0;
+    for (size_t i = 0; i < pooled.size(); )
+    {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j] == pooled[i]) j++;
+        double t = static_cast<double>(j - i);
+        tieSum += t * t * t - t;
+        i = j;
+    }
+    double n = n1 + n2;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - tieSum / (n * (n - 1)));
+    if (variance <= 0) {
+        return 1;
+    }
+    double z = (u - most / 2.0 - 0.5) / sqrt(variance);
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+//Compares every result that is in the baseline. A benchmark has regressed
+//when its median is more than threshold (0.05 is 5%) slower and the
+//Mann-Whitney test puts the chance of that being noise below alpha.
+inline vector<BaselineComparison> compareToBaseline(const vector<BenchmarkResult>& results,
+                                                    const BenchmarkBaseline& baseline,
+                                                    double threshold, double alpha)
+{
+    vector<BaselineComparison> comparisons;
+    for (const auto& result : results)
+    {
+        auto saved = baseline.find(result.name);
+        if (saved == baseline.end() || result.samples.empty()) continue;
+        BaselineComparison comparison;
+        comparison.name = result.name;
+        comparison.baselineNs = median(saved->second);
+        comparison.currentNs = median(result.samples);
+        comparison.change = comparison.baselineNs > 0 ? comparison.currentNs / comparison.baselineNs - 1 : 0;
+        comparison.p = mannWhitneyGreater(result.samples, saved->second);
+        comparison.regressed = comparison.change > threshold && comparison.p < alpha;
+        comparisons.push_back(comparison);
+    }
+    return comparisons;
+}
+
+#endif
@@ -1,91 +1,62 @@
 #ifndef CARD_H
 #define CARD_H
 #include <iostream>
-#include <map>
+#include <cstdint>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 using namespace std;
 
 class Card
 {
 private:
-    map<int, string> cardRankRef = { 
-        {1, "3"},
-        {2, "4"},
-        {3, "5"},
-        {4, "6"},
-        {5, "7"},
-        {6, "8"},
-        {7, "9"},
-        {8, "10"},
-        {9, "J"},
-        {10, "Q"},
-        {11, "K"},
-        {12, "A"},
-        {13, "2"}}; //Map for card rank
-    map<int, char> cardSuitesRef = 
-    {{1, '&'},
-    {2, '^'},
-    {3, 'V'},
-    {4, 'O'}};  //Map for suit rank
+    //Name tables shared by every class, index 0 is unused so ranks and suits index them directly
+    static constexpr const char* RANK_NAMES[14] =
+        {"", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K", "A", "2"};  //Card rank names
+    static constexpr char SUIT_NAMES[5] = {' ', '&', '^', 'V', 'O'};           //Suit symbols
 
-    int card;         //Determines type of card BASIC: 2-10,J,Q,K,A
-    int suit;        //Determines suit - BASIC:& (clubs), ^ (spades), V (hearts), O (diamonds)
+    uint8_t index;   //(card - 1) * 4 + (suit - 1), the same bit the card owns in a CardSet
+                     //card: BASIC: 2-10,J,Q,K,A   suit: BASIC:& (clubs), ^ (spades), V (hearts), O (diamonds)
 
     // Helper function to validate card values
-    bool isValidCard(int c, int s) const {
+    static constexpr bool isValidCard(int c, int s) {
         return c >= 1 && c <= 13 && s >= 1 && s <= 4;
     }
 
 public:
     //---GENERAL FUNCTIONS---
-    Card(int, int);   //Instantiation constructor
-    ~Card() = default;  //Destructor
+    Card() : index(0) {}  //The 3 of clubs
+    Card(int, int);       //Instantiation constructor
     //---SPECIAL FUNCTIONS---
-    int getCard() const;
-    int getSuit() const;
-    bool operator==(const Card&) const;
+    int getCard() const { return index / 4 + 1; }
+    int getSuit() const { return index % 4 + 1; }
+    int getIndex() const { return index; }
+    static Card fromIndex(int I) { Card C; C.index = static_cast<uint8_t>(I); return C; }
+    bool operator==(const Card& other) const { return index == other.index; }
+    bool operator!=(const Card& other) const { return index != other.index; }
+    //---NAMES---
+    static const char* rankName(int rank) { return rank >= 1 && rank <= 13 ? RANK_NAMES[rank] : ""; }
+    static char suitName(int suit) { return suit >= 1 && suit <= 4 ? SUIT_NAMES[suit] : ' '; }
     //---DEBUG FUNCTIONS---
     void displayCard() const;
 };
 
+static_assert(sizeof(Card) == 1, "Card should stay one byte");
+static_assert(is_trivially_copyable<Card>::value, "Card should copy like a plain byte");
+
 //Dynamic constructor
-Card::Card(int CARD, int SUIT)
+inline Card::Card(int CARD, int SUIT)
 {
     if (!isValidCard(CARD, SUIT)) {
         throw invalid_argument("Invalid card values: rank=" + to_string(CARD) + ", suit=" + to_string(SUIT));
     }
-    card = CARD;
-    suit = SUIT;
-}
-
-//Get Functions
-int Card::getCard() const
-{
-    return card;
-}
-
-int Card::getSuit() const
-{
-    return suit;
+    index = static_cast<uint8_t>((CARD - 1) * 4 + (SUIT - 1));
 }
 
 //Displays the current card info
-void Card::displayCard() const
-{
-    auto rankIt = cardRankRef.find(card);
-    auto suitIt = cardSuitesRef.find(suit);
-    
-    if (rankIt != cardRankRef.end() && suitIt != cardSuitesRef.end()) {
-        cout << rankIt->second << " of " << suitIt->second;
-    } else {
-        cout << "Invalid card: Rank=" << card << ", Suit=" << suit;
-    }
-}
-
-//Helps with the equal operator
-bool Card::operator==(const Card& other) const
+inline void Card::displayCard() const
 {
-    return card == other.card && suit == other.suit;
+    cout << rankName(getCard()) << " of " << suitName(getSuit());
 }
 
-#endif 
+#endif
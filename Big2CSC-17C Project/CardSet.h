@@ -0,0 +1,137 @@
+#ifndef CARDSET_H
+#define CARDSET_H
+#include "Card.h"
+#include <cstdint>
+#include <iterator>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+using namespace std;
+
+//---BIT HELPERS---
+//Counts the set bits of a 64 bit word
+inline int popCount64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(x));
+#else
+    int count = 0;
+    while (x) { x &= x - 1; ++count; }
+    return count;
+#endif
+}
+//Index of the lowest set bit (x must not be 0)
+inline int lowestBit64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    int index = 0;
+    while (!(x & 1)) { x >>= 1; ++index; }
+    return index;
+#endif
+}
+//Index of the highest set bit (x must not be 0)
+inline int highestBit64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return static_cast<int>(index);
+#else
+    int index = 0;
+    while (x >>= 1) ++index;
+    return index;
+#endif
+}
+
+//A set of cards stored as a 52 bit mask.
+//Bits are laid out rank major: bit = (rank - 1) * 4 + (suit - 1), so the
+//3 of clubs is bit 0, the 2 of diamonds is bit 51 and every rank owns one nibble.
+class CardSet
+{
+private:
+    uint64_t mask;      //One bit per card in the set
+
+public:
+    static constexpr int CARD_COUNT = 52;
+    static constexpr uint64_t FULL_MASK = (1ULL << 52) - 1;
+    static constexpr uint64_t SUIT_MASK = 0x1111111111111ULL;  //Every bit of suit 1 (shift by suit - 1)
+
+    //Walks the cards of the set from lowest to highest bit
+    class iterator
+    {
+    private:
+        uint64_t remaining;
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = Card;
+        using difference_type = ptrdiff_t;
+        using pointer = const Card*;
+        using reference = Card;
+
+        explicit iterator(uint64_t m) : remaining(m) {}
+        Card operator*() const { return cardAt(lowestBit64(remaining)); }
+        iterator& operator++() { remaining &= remaining - 1; return *this; }
+        iterator operator++(int) { iterator temp = *this; ++(*this); return temp; }
+        bool operator==(const iterator& other) const { return remaining == other.remaining; }
+        bool operator!=(const iterator& other) const { return remaining != other.remaining; }
+    };
+
+    //---GENERAL FUNCTIONS---
+    CardSet() : mask(0) {}                             //Empty set
+    explicit CardSet(uint64_t m) : mask(m & FULL_MASK) {}
+    static CardSet fullDeck() { return CardSet(FULL_MASK); }
+
+    //---INDEX CONVERSION---
+    static int indexOf(int rank, int suit) { return (rank - 1) * 4 + (suit - 1); }
+    static int indexOf(const Card& C) { return C.getIndex(); }
+    static Card cardAt(int index) { return Card::fromIndex(index); }
+    static uint64_t bitOf(const Card& C) { return 1ULL << indexOf(C); }
+
+    //---SPECIAL FUNCTIONS---
+    bool contains(const Card& C) const { return (mask & bitOf(C)) != 0; }
+    bool containsIndex(int index) const { return (mask >> index) & 1; }
+    bool containsAll(CardSet other) const { return (mask & other.mask) == other.mask; }
+    void add(const Card& C) { mask |= bitOf(C); }
+    void addIndex(int index) { mask |= 1ULL << index; }
+    void add(CardSet other) { mask |= other.mask; }
+    void remove(const Card& C) { mask &= ~bitOf(C); }
+    void removeIndex(int index) { mask &= ~(1ULL << index); }
+    void remove(CardSet other) { mask &= ~other.mask; }
+    void clear() { mask = 0; }
+
+    int size() const { return popCount64(mask); }
+    bool empty() const { return mask == 0; }
+    uint64_t getMask() const { return mask; }
+
+    //Amount of cards of the given rank (1-13) or suit (1-4)
+    int rankCount(int rank) const { return popCount64((mask >> ((rank - 1) * 4)) & 0xF); }
+    int suitCount(int suit) const { return popCount64(mask & (SUIT_MASK << (suit - 1))); }
+    CardSet ofRank(int rank) const { return CardSet(mask & (0xFULL << ((rank - 1) * 4))); }
+    CardSet ofSuit(int suit) const { return CardSet(mask & (SUIT_MASK << (suit - 1))); }
+
+    //Lowest / highest card by rank then suit (set must not be empty)
+    int lowestIndex() const { return lowestBit64(mask); }
+    int highestIndex() const { return highestBit64(mask); }
+
+    iterator begin() const { return iterator(mask); }
+    iterator end() const { return iterator(0); }
+
+    //---OPERATOR OVERLOADS---
+    CardSet operator|(CardSet other) const { return CardSet(mask | other.mask); }
+    CardSet operator&(CardSet other) const { return CardSet(mask & other.mask); }
+    CardSet operator-(CardSet other) const { return CardSet(mask & ~other.mask); }
+    bool operator==(CardSet other) const { return mask == other.mask; }
+    bool operator!=(CardSet other) const { return mask != other.mask; }
+};
+
+#endif
@@ -1,56 +1,44 @@
 #ifndef DECK_H
 #define DECK_H
 #include "Card.h"
+#include "CardSet.h"
+#include "Random.h"
 #include <list>
 #include <iostream>
 #include <deque>
-#include <map>
 #include <algorithm>
-#include <random>
-#include <chrono>
+#include <cstdint>
+#include <cstring>
 using namespace std;
 
 class Deck
 {
 private:
-    deque<Card> Cards;              //Used to store all the card objects
-    map<int, string> cardRankRef = { 
-    {1, "3"},
-    {2, "4"},
-    {3, "5"},
-    {4, "6"},
-    {5, "7"},
-    {6, "8"},
-    {7, "9"},
-    {8, "10"},
-    {9, "J"},
-    {10, "Q"},
-    {11, "K"},
-    {12, "A"},
-    {13, "2"}}; //Map for card rank
-    map<int, char> cardSuitesRef = 
-    {{1, '&'},
-    {2, '^'},
-    {3, 'V'},
-    {4, 'O'}};  //Map for suit rank
+    CardSet Members;                //Which cards are in the deck (constant time lookups)
+    uint8_t Order[52];              //Card indices (see CardSet) from top to bottom
+    int First = 0;                  //Position of the top card inside Order
+    int Count = 0;                  //Amount of cards inside Order
+    Philox4x32 Engine;              //Stream every shuffle and deal draws from (see seed)
 
-    // Helper function to get a time-based seed
-    unsigned int getTimeBasedSeed() {
-        auto now = chrono::high_resolution_clock::now();
-        auto time = now.time_since_epoch();
-        auto count = chrono::duration_cast<chrono::nanoseconds>(time).count();
-        return static_cast<unsigned int>(count);
-    }
+    // Helper functions for the fixed order buffer
+    int indexAt(int I) const { return Order[First + I]; }
+    int positionOf(int cardIndex) const;
+    void eraseAt(int I);
 
 public:
     Deck() = default;
     Deck(int);                      //Creates a deck with 0 cards in it
+    Deck(int, unsigned int);        //Creates a 52 card deck shuffled with a fixed seed
     Deck(Card);                     //Creates a deck with one card in it
     Deck(list<Card>);               //Creates a deck out of a given amount of cards
     ~Deck() = default;              //Destroys the deck
     
     //---SPECIAL FUNCTIONS---
+    void fillDeck();                //Empties the deck then puts all 52 cards back in order
     void shuffleDeck();
+    void shuffleDeck(unsigned int); //Shuffles with a fixed seed so a deal can be replayed
+    void seed(uint64_t, uint64_t = 0);      //Draws from stream of seed from now on (see Random.h)
+    void dealHands(int, int, CardSet[]);    //Deals cardsEach cards to numPlayers hands (cards stay in the deck)
     void sortDeck();
     void displayDeck();
 
@@ -60,10 +48,15 @@ public:
     Card takeCardFromDeck(int);
     list<Card> selectCardsAndTakeFromDeck(list<int>);
     list<Card> getCards() const;
+    const CardSet& getCardSet() const;
+    bool contains(const Card&) const;
+    bool empty() const;
     int amountOfCards();
     void placeCardIntoDeck(Card);
     void placeCardsIntoDeck(list<Card>);
+    void placeCardsIntoDeck(CardSet);
     void removeCard(const Card& card);
+    void removeCards(CardSet);
     int size() const;
 };
 
@@ -72,76 +65,117 @@ Deck::Deck(int i)
 {
     if(i == 52) {
         // Create all cards in order
-        for(int i=1; i <= 4; i++) {
-            for(int j=1; j <= 13; j++) {
-                Cards.push_back(Card(j,i));
-            }
-        }
-        // Shuffle immediately using time-based seed
+        fillDeck();
+        // Shuffle immediately from the deck's stream
         shuffleDeck();
     }
 }
+//Creates a 52 deck shuffled from a given seed (same seed, same deal)
+Deck::Deck(int i, unsigned int seed)
+{
+    if(i == 52) {
+        fillDeck();
+        shuffleDeck(seed);
+    }
+}
+//Puts every card back in the deck, sorted by suit then rank
+void Deck::fillDeck()
+{
+    Members.clear();
+    First = 0;
+    Count = 0;
+    for(int i=1; i <= 4; i++) {
+        for(int j=1; j <= 13; j++) {
+            placeCardIntoDeck(Card(j,i));
+        }
+    }
+}
+//Creates a deck with one card in it
+Deck::Deck(Card C)
+{
+    placeCardIntoDeck(C);
+}
+//Creates a deck out of a given amount of cards
+Deck::Deck(list<Card> Cs)
+{
+    placeCardsIntoDeck(Cs);
+}
 
+//Shuffles with the next numbers of the deck's stream, seed the deck to replay it
 void Deck::shuffleDeck()
 {
-    // Get a time-based seed
-    unsigned int seed = getTimeBasedSeed();
-    
-    // Combine with random device for additional entropy
-    random_device rd;
-    seed ^= rd();
-    
-    // Use the combined seed to initialize the Mersenne Twister
-    mt19937 g(seed);
-    
-    // Shuffle the deck using STL's shuffle
-    shuffle(Cards.begin(), Cards.end(), g);
+    shuffle(Order + First, Order + First + Count, Engine);
+}
+void Deck::shuffleDeck(unsigned int seed)
+{
+    Philox4x32 g(seed);
+    shuffle(Order + First, Order + First + Count, g);
+}
+void Deck::seed(uint64_t seed, uint64_t stream)
+{
+    Engine = Philox4x32(seed, stream);
+}
+//Deals cardsEach cards to each of numPlayers hands, one card per player at a
+//time, with a Fisher-Yates shuffle of only the positions that get dealt.
+//The cards stay in the deck (only their order changes), so a full deck deals
+//game after game without being refilled.
+void Deck::dealHands(int numPlayers, int cardsEach, CardSet hands[])
+{
+    if (numPlayers < 1 || cardsEach < 0 || numPlayers * cardsEach > Count) {
+        throw invalid_argument("Cannot deal " + to_string(cardsEach) + " cards to " + to_string(numPlayers) +
+                               " players from " + to_string(Count) + " cards");
+    }
+    for (int player = 0; player < numPlayers; player++)
+    {
+        hands[player].clear();
+    }
+    // Start from the cards lowest first, so the deal only depends on which cards
+    // the deck holds and its stream, not on the order an earlier deal left behind
+    uint8_t* order = Order + First;
+    int position = 0;
+    for (uint64_t rest = Members.getMask(); rest != 0; rest &= rest - 1)
+    {
+        order[position++] = static_cast<uint8_t>(lowestBit64(rest));
+    }
+    int dealt = numPlayers * cardsEach;
+    int player = 0;
+    for (int i = 0; i < dealt; i++)
+    {
+        swap(order[i], order[i + Engine.below(Count - i)]);
+        hands[player].addIndex(order[i]);
+        if (++player == numPlayers) player = 0;
+    }
 }
 
 Card Deck::takeRandomFromDeck()
 {
-    if (Cards.empty()) {
+    if (Count == 0) {
         throw runtime_error("Deck is empty");
     }
     
-    // Get a time-based seed
-    unsigned int seed = getTimeBasedSeed();
-    
-    // Combine with random device for additional entropy
-    random_device rd;
-    seed ^= rd();
-    
-    // Use the combined seed to initialize the Mersenne Twister
-    mt19937 g(seed);
-    
-    // Get a random index
-    uniform_int_distribution<size_t> dist(0, Cards.size() - 1);
-    size_t randomIndex = dist(g);
+    // Get a random index from the deck's stream
+    int randomIndex = static_cast<int>(Engine.below(Count));
     
     // Get the card and remove it
-    auto it = Cards.begin();
-    advance(it, randomIndex);
-    Card C = *it;
-    Cards.erase(it);
+    Card C = CardSet::cardAt(indexAt(randomIndex));
+    eraseAt(randomIndex);
     return C;
 }
 
 Card Deck::takeCardFromDeck(int I)
 {
-    if (Cards.empty()) {
+    if (Count == 0) {
         throw runtime_error("Deck is empty");
     }
-    if (I < 0 || I >= Cards.size()) {
-        throw runtime_error("Invalid card index: " + to_string(I) + " (deck size: " + to_string(Cards.size()) + ")");
+    if (I < 0 || I >= Count) {
+        throw runtime_error("Invalid card index: " + to_string(I) + " (deck size: " + to_string(Count) + ")");
     }
     
     // Get the card at the specified index
-    auto it = Cards.begin();
-    advance(it, I);
-    Card C = *it;
+    Card C = CardSet::cardAt(indexAt(I));
     
     // Remove the card from the deck
-    Cards.erase(it);
+    eraseAt(I);
     
     return C;
 }
@@ -149,64 +183,81 @@ Card Deck::takeCardFromDeck(int I)
 //Sort the deck to be neat again
 void Deck::sortDeck()
 {
-    sort(Cards.begin(), Cards.end(),
-    [](const Card& a, const Card& b) {
-        if (a.getSuit() != b.getSuit()) {
-            return a.getSuit() < b.getSuit();  // Sort by suit first: 1=&, 2=^, etc.
+    sort(Order + First, Order + First + Count,
+    [](uint8_t a, uint8_t b) {
+        if (a % 4 != b % 4) {
+            return a % 4 < b % 4;  // Sort by suit first: 1=&, 2=^, etc.
         }
-        return a.getCard() < b.getCard();      // Then by rank within suit: 1=3 ... 13=2
+        return a < b;              // Then by rank within suit: 1=3 ... 13=2
     });
 }
-//Uses maps to display the character & string oriented with numbered index
+//Uses the shared name tables to display the character & string of every card
 void Deck::displayDeck()
 {
-    for(const auto& card : Cards)
+    for(int i = 0; i < Count; i++)
     {
-        // Use find() instead of at() to safely check if the key exists
-        auto rankIt = cardRankRef.find(card.getCard());
-        auto suitIt = cardSuitesRef.find(card.getSuit());
-        
-        if (rankIt != cardRankRef.end() && suitIt != cardSuitesRef.end()) {
-            cout << rankIt->second << " of " << suitIt->second << endl;
-        } else {
-            cout << "Invalid card: Rank=" << card.getCard() << ", Suit=" << card.getSuit() << endl;
-        }
+        CardSet::cardAt(indexAt(i)).displayCard();
+        cout << endl;
     }
 }
 //Takes a card from the top of the deck
 Card Deck::takeTopFromDeck()
 {
-    if (Cards.empty()) {
+    if (Count == 0) {
         throw runtime_error("Deck is empty");
     }
-    Card C = Cards.front();
-    Cards.pop_front();
-    return C;
+    int index = Order[First];
+    First++;
+    Count--;
+    Members.removeIndex(index);
+    return CardSet::cardAt(index);
 }
 //Takes a card from the bottom of the deck
 Card Deck::takeBottomFromDeck()
 {
-    if (Cards.empty()) {
+    if (Count == 0) {
         throw runtime_error("Deck is empty");
     }
-    Card C = Cards.back();
-    Cards.pop_back();
-    return C;
+    int index = Order[First + Count - 1];
+    Count--;
+    Members.removeIndex(index);
+    return CardSet::cardAt(index);
 }
 //Returns the amount of cards this deck has
 int Deck::amountOfCards()
 {
-    return Cards.size();
+    return Count;
 }
 //Places a card into the deck
 void Deck::placeCardIntoDeck(Card C)
 {
-    Cards.push_back(C);
+    if (Members.contains(C)) {
+        throw invalid_argument("Card is already in the deck: rank=" + to_string(C.getCard()) + ", suit=" + to_string(C.getSuit()));
+    }
+    // Slide the cards back to the front of the buffer once the bottom is reached
+    if (First + Count == 52) {
+        memmove(Order, Order + First, Count);
+        First = 0;
+    }
+    Order[First + Count] = static_cast<uint8_t>(CardSet::indexOf(C));
+    Count++;
+    Members.add(C);
 }
 //Places a list of cards into the deck
 void Deck::placeCardsIntoDeck(list<Card> Cs)
 {
-    Cards.insert(Cards.end(),Cs.begin(),Cs.end());
+    for (const auto& card : Cs)
+    {
+        placeCardIntoDeck(card);
+    }
+}
+//Places a set of cards into the deck (lowest card first)
+void Deck::placeCardsIntoDeck(CardSet Cs)
+{
+    for (const auto& card : Cs)
+    {
+        placeCardIntoDeck(card);
+    }
 }
 //Selects cards then take them out of the deck
 list<Card> Deck::selectCardsAndTakeFromDeck(list<int> selection)
@@ -214,38 +265,84 @@ list<Card> Deck::selectCardsAndTakeFromDeck(list<int> selection)
     std::list<Card> temp;
 
     // Convert selection of indices to actual Card objects
-    auto it = Cards.begin();
     for (const auto& i : selection)
     {
-        std::advance(it, i);  // Move iterator to the desired index
-        temp.push_back(*it);  // Add the selected card to temp
-        it = Cards.begin();  // Reset iterator to beginning for next selection
+        if (i >= 0 && i < Count) {
+            temp.push_back(CardSet::cardAt(indexAt(i)));  // Add the selected card to temp
+        }
     }
 
     // Now remove selected cards from the original deck
     for (const auto& card : temp)
     {
-        auto removeIt = std::find(Cards.begin(), Cards.end(), card);
-        if (removeIt != Cards.end()) {
-            Cards.erase(removeIt);  // Remove the card from the deck
-        }
+        removeCard(card);
     }
 
     return temp;  // Return the list of selected cards
 }
 list<Card> Deck::getCards() const
 {
-    return list<Card>(Cards.begin(), Cards.end());
+    list<Card> temp;
+    for (int i = 0; i < Count; i++)
+    {
+        temp.push_back(CardSet::cardAt(indexAt(i)));
+    }
+    return temp;
+}
+//Returns the cards of the deck as a bit set without copying them
+const CardSet& Deck::getCardSet() const
+{
+    return Members;
+}
+bool Deck::contains(const Card& card) const
+{
+    return Members.contains(card);
+}
+bool Deck::empty() const
+{
+    return Count == 0;
 }
 // Removes a specific card from the deck
 void Deck::removeCard(const Card& card) {
-    auto it = std::find(Cards.begin(), Cards.end(), card);
-    if (it != Cards.end()) {
-        Cards.erase(it);
+    if (!Members.contains(card)) {
+        return;
     }
+    eraseAt(positionOf(CardSet::indexOf(card)));
+}
+// Removes every card of the set that is in the deck
+void Deck::removeCards(CardSet Cs) {
+    Cs = Cs & Members;
+    if (Cs.empty()) {
+        return;
+    }
+    // One pass over the order buffer keeps the cards that are not being removed
+    int kept = 0;
+    for (int i = 0; i < Count; i++) {
+        int index = Order[First + i];
+        if (!Cs.containsIndex(index)) {
+            Order[First + kept] = static_cast<uint8_t>(index);
+            kept++;
+        }
+    }
+    Count = kept;
+    Members.remove(Cs);
 }
    int Deck::size() const
    {
-        return Cards.size();
+        return Count;
    }
-#endif 
\ No newline at end of file
+//Finds where a card index sits in the order buffer (card must be in the deck)
+int Deck::positionOf(int cardIndex) const
+{
+    const uint8_t* it = static_cast<const uint8_t*>(memchr(Order + First, cardIndex, Count));
+    return static_cast<int>(it - (Order + First));
+}
+//Removes the card at a position of the order buffer
+void Deck::eraseAt(int I)
+{
+    int index = Order[First + I];
+    memmove(Order + First + I, Order + First + I + 1, Count - I - 1);
+    Count--;
+    Members.removeIndex(index);
+}
+#endif
\ No newline at end of file
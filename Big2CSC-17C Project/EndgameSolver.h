@@ -0,0 +1,299 @@
+#ifndef ENDGAMESOLVER_H
+#define ENDGAMESOLVER_H
+#include "GameEngine.h"
+#include "Random.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+//When and how hard the endgame solver works
+struct EndgameConfig
+{
+    int cardThreshold = 10;             //Takes over once every seat together holds this many cards or fewer
+    int samples = 8;                    //Deals of the unseen cards solved per move
+    size_t tableBytes = 4 << 20;        //Memory cap of the transposition table
+    long long maxNodes = 500000;        //Nodes per move before giving the move back to the normal AI
+};
+
+//Totals over every move the solver was asked for
+struct EndgameStats
+{
+    long long moves = 0;        //Moves picked by the solver
+    long long gaveUp = 0;       //Moves handed back (node limit hit or no winning line)
+    long long nodes = 0;
+    long long probes = 0;       //Transposition table lookups
+    long long hits = 0;
+    double seconds = 0;
+
+    double nodesPerSecond() const { return seconds > 0 ? nodes / seconds : 0; }
+    double hitRate() const { return probes > 0 ? static_cast<double>(hits) / probes : 0; }
+    void merge(const EndgameStats& other)
+    {
+        moves += other.moves;
+        gaveUp += other.gaveUp;
+        nodes += other.nodes;
+        probes += other.probes;
+        hits += other.hits;
+        seconds += other.seconds;
+    }
+};
+
+//Exact solver for the last few cards of a game. A position is won for a seat
+//when that seat can run out of cards first whatever the other three do (they
+//are assumed to play together against it), so the search is an AND/OR tree:
+//any winning move at the seat's own turns, every move at the others' turns.
+//Positions are hashed with Zobrist keys (a random key per card and owner, per
+//card of the hand to beat, per seat to move and pass count) and results are
+//kept in a fixed size, always replace transposition table.
+//A seat only sees its own cards, so chooseMove solves several deals of the
+//unseen cards and plays the move that wins in the most of them.
+class EndgameSolver
+{
+private:
+    struct ZobristKeys
+    {
+        uint64_t hand[GAME_SEATS][CardSet::CARD_COUNT];
+        uint64_t top[CardSet::CARD_COUNT];
+        uint64_t seat[GAME_SEATS];
+        uint64_t passes[GAME_SEATS];
+        uint64_t root[GAME_SEATS];      //Seat the result is for
+    };
+    static constexpr ZobristKeys buildKeys();
+    static const ZobristKeys KEYS;
+
+    EndgameConfig config;
+    EndgameStats stats;
+    vector<uint64_t> table;         //Key with the result in bit 0, 0 when empty
+    uint64_t tableMask = 0;
+    vector<MoveList> moveStack;     //Moves of every search depth
+    UndoStack undo;                 //The search plays and takes back moves on one state
+    MoveList rootMoves;
+    vector<int> rootWins;
+    long long nodeLimit = 0;        //stats.nodes at which the current move gives up
+    uint64_t gameKey = 0;           //Mixed into every hash so games never read each other's results
+    bool outOfNodes = false;
+
+    static uint64_t keysOf(const uint64_t* keys, CardSet cards);
+    static uint64_t hashAfter(const GameState& before, CardSet move, uint64_t hash);
+    bool wins(GameState& state, uint64_t hash, int root, int depth);
+
+public:
+    explicit EndgameSolver(const EndgameConfig& config = EndgameConfig());
+
+    //True when the cards left at the table are few enough to solve
+    bool appliesTo(const TableView& view) const;
+    //Starts a new game: the table keeps its memory but the entries of earlier games
+    //no longer match, so a game plays the same whatever was solved before it
+    void startGame(uint64_t key) { gameKey = key; }
+    //Zobrist hash of a position solved for root
+    static uint64_t hashOf(const GameState& state, int root);
+    //1 when root wins state with perfect play, 0 when it does not, -1 when the node limit was hit
+    int solve(const GameState& state, int root);
+    //Picks the play of view.seat (an empty move passes). Returns false when the
+    //node limit was hit or no move wins any deal, the normal AI should move then.
+    bool chooseMove(CardSet hand, CardSet top, const TableView& view, uint64_t seed, CardSet& move);
+    const EndgameStats& getStats() const { return stats; }
+    const EndgameConfig& getConfig() const { return config; }
+};
+
+//Fills the key table from splitmix64 so it is the same on every run
+constexpr EndgameSolver::ZobristKeys EndgameSolver::buildKeys()
+{
+    ZobristKeys keys = {};
+    uint64_t state = 0x243F6A8885A308D3ULL;
+    auto next = [&state]() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    };
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+        for (int card = 0; card < CardSet::CARD_COUNT; card++)
+            keys.hand[seat][card] = next();
+    for (int card = 0; card < CardSet::CARD_COUNT; card++)
+        keys.top[card] = next();
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        keys.seat[seat] = next();
+        keys.passes[seat] = next();
+        keys.root[seat] = next();
+    }
+    return keys;
+}
+inline constexpr EndgameSolver::ZobristKeys EndgameSolver::KEYS = EndgameSolver::buildKeys();
+
+inline EndgameSolver::EndgameSolver(const EndgameConfig& settings)
+    : config(settings)
+{
+    size_t entries = 1;
+    while (entries * 2 * sizeof(uint64_t) <= config.tableBytes) entries *= 2;
+    table.assign(entries, 0);
+    tableMask = entries - 1;
+    // Every four plies at least one card leaves the table, so this is as deep as a search goes
+    moveStack.resize(4 * config.cardThreshold + 8);
+}
+inline bool EndgameSolver::appliesTo(const TableView& view) const
+{
+    int cards = 0;
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        cards += view.handSizes[seat];
+    }
+    return cards <= config.cardThreshold;
+}
+inline uint64_t EndgameSolver::keysOf(const uint64_t* keys, CardSet cards)
+{
+    uint64_t hash = 0;
+    for (uint64_t rest = cards.getMask(); rest != 0; rest &= rest - 1)
+    {
+        hash ^= keys[lowestBit64(rest)];
+    }
+    return hash;
+}
+inline uint64_t EndgameSolver::hashOf(const GameState& state, int root)
+{
+    uint64_t hash = KEYS.root[root] ^ KEYS.seat[state.seat] ^ KEYS.passes[state.passes] ^
+                    keysOf(KEYS.top, state.top);
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        hash ^= keysOf(KEYS.hand[seat], state.hands[seat]);
+    }
+    return hash;
+}
+//Updates the hash the same way GameEngine::apply updates the state
+inline uint64_t EndgameSolver::hashAfter(const GameState& before, CardSet move, uint64_t hash)
+{
+    int seat = before.seat;
+    hash ^= KEYS.seat[seat] ^ KEYS.seat[(seat + 1) % GAME_SEATS] ^ KEYS.passes[before.passes];
+    if (move.empty()) {
+        int passes = before.passes + 1;
+        if (passes >= GAME_SEATS - 1) {
+            return hash ^ keysOf(KEYS.top, before.top) ^ KEYS.passes[0];
+        }
+        return hash ^ KEYS.passes[passes];
+    }
+    return hash ^ keysOf(KEYS.hand[seat], move) ^ keysOf(KEYS.top, before.top) ^
+           keysOf(KEYS.top, move) ^ KEYS.passes[0];
+}
+inline bool EndgameSolver::wins(GameState& state, uint64_t hash, int root, int depth)
+{
+    stats.probes++;
+    uint64_t& entry = table[hash & tableMask];
+    if (entry != 0 && (entry | 1) == (hash | 1)) {
+        stats.hits++;
+        return (entry & 1) != 0;
+    }
+    if (++stats.nodes > nodeLimit || depth >= static_cast<int>(moveStack.size())) {
+        outOfNodes = true;
+        return false;
+    }
+
+    int mover = state.seat;
+    bool ownTurn = mover == root;
+    MoveList& moves = moveStack[depth];
+    GameEngine::legalMoves(state, moves);
+
+    bool result = !ownTurn;     //OR at our turns, AND at theirs
+    // Going out ends the game at once, no need to look any further
+    CardSet hand = state.hands[mover];
+    bool canGoOut = false;
+    for (const auto& move : moves)
+    {
+        if (move == hand) {
+            canGoOut = true;
+            break;
+        }
+    }
+    if (canGoOut) {
+        result = ownTurn;
+    } else {
+        for (const auto& move : moves)
+        {
+            uint64_t childHash = hashAfter(state, move, hash);
+            GameEngine::applyMove(state, move, undo);
+            bool won = wins(state, childHash, root, depth + 1);
+            GameEngine::undoMove(state, undo);
+            if (outOfNodes) {
+                return false;
+            }
+            if (won == ownTurn) {
+                result = won;
+                break;
+            }
+        }
+    }
+    entry = (hash & ~1ULL) | (result ? 1 : 0);
+    return result;
+}
+inline int EndgameSolver::solve(const GameState& state, int root)
+{
+    outOfNodes = false;
+    nodeLimit = stats.nodes + config.maxNodes;
+    undo.clear();
+    GameState position = state;
+    bool won = wins(position, hashOf(state, root) ^ gameKey, root, 0);
+    return outOfNodes ? -1 : (won ? 1 : 0);
+}
+inline bool EndgameSolver::chooseMove(CardSet hand, CardSet top, const TableView& view, uint64_t seed,
+                                      CardSet& move)
+{
+    auto start = chrono::steady_clock::now();
+    Xoshiro256 rng(seed);
+    int seat = view.seat;
+
+    GameState rootState;
+    rootState.seat = static_cast<uint8_t>(seat);
+    rootState.hands[seat] = hand;
+    GameEngine::setTop(rootState, top);
+    GameEngine::legalMoves(rootState, rootMoves);
+    rootWins.assign(rootMoves.size(), 0);
+
+    // With one other seat holding cards there is a single possible deal
+    int seatsHidingCards = 0;
+    for (int other = 0; other < GAME_SEATS; other++)
+    {
+        if (other != seat && view.handSizes[other] > 0) seatsHidingCards++;
+    }
+    int samples = seatsHidingCards <= 1 ? 1 : config.samples;
+
+    outOfNodes = false;
+    nodeLimit = stats.nodes + config.maxNodes;
+    undo.clear();
+    for (int sample = 0; sample < samples && !outOfNodes; sample++)
+    {
+        GameState deal = GameEngine::determinize(hand, top, view, rng);
+        uint64_t hash = hashOf(deal, seat) ^ gameKey;
+        for (int i = 0; i < rootMoves.size() && !outOfNodes; i++)
+        {
+            CardSet option = rootMoves[i];
+            if (option == hand) {
+                rootWins[i]++;
+                continue;
+            }
+            uint64_t childHash = hashAfter(deal, option, hash);
+            GameEngine::applyMove(deal, option, undo);
+            if (wins(deal, childHash, seat, 0)) {
+                rootWins[i]++;
+            }
+            GameEngine::undoMove(deal, undo);
+        }
+    }
+
+    int best = 0;
+    for (int i = 1; i < rootMoves.size(); i++)
+    {
+        if (rootWins[i] > rootWins[best]) best = i;
+    }
+    stats.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (outOfNodes || rootWins[best] == 0) {
+        stats.gaveUp++;
+        return false;
+    }
+    stats.moves++;
+    move = rootMoves[best];
+    return true;
+}
+
+#endif
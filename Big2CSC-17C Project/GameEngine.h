@@ -0,0 +1,236 @@
+#ifndef GAMEENGINE_H
+#define GAMEENGINE_H
+#include "BatchEvaluator.h"
+#include "CardSet.h"
+#include "HandEvaluator.h"
+#include "MoveGenerator.h"
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+using namespace std;
+
+const int GAME_SEATS = 4;           //Seats at a table
+
+//What a seat can see of the table when it is its turn
+struct TableView
+{
+    int seat = 0;                       //Seat that is deciding (0-3)
+    int handSizes[GAME_SEATS] = {};     //Cards left in every seat
+    CardSet played;                     //Cards out of the game, the hand to beat included
+    int passes = 0;                     //Passes since the hand to beat was played
+};
+
+//A whole position with every hand known. Plain data of a fixed size, so
+//copying one (a search trying a move, a simulator saving a position) is a memcpy.
+struct GameState
+{
+    CardSet hands[GAME_SEATS];
+    CardSet top;                //Hand to beat, empty when the seat to move leads
+    uint32_t topKey = 0;        //HandEvaluator::orderKey of top, 0 when empty
+    uint8_t seat = 0;           //Seat to move
+    uint8_t passes = 0;         //Passes since top was played
+};
+
+static_assert(is_trivially_copyable<GameState>::value, "GameState has to copy with a memcpy");
+static_assert(sizeof(GameState) <= 48, "GameState should stay within a cache line");
+
+//Everything applyMove overwrites, enough to put the state back
+struct UndoRecord
+{
+    CardSet move;
+    CardSet top;
+    uint32_t topKey;
+    uint8_t seat;
+    uint8_t passes;
+};
+
+//Fixed size stack of the moves applied to a state, newest last
+class UndoStack
+{
+public:
+    //Deeper than any game: a card leaves the table at least every four moves
+    static const int MAX_DEPTH = 4 * CardSet::CARD_COUNT + 8;
+
+private:
+    UndoRecord Records[MAX_DEPTH];
+    int Count = 0;
+
+public:
+    void push(const UndoRecord& record)
+    {
+        if (Count == MAX_DEPTH) {
+            throw length_error("Undo stack is full");
+        }
+        Records[Count++] = record;
+    }
+    const UndoRecord& pop()
+    {
+        if (Count == 0) {
+            throw out_of_range("Nothing to undo");
+        }
+        return Records[--Count];
+    }
+    void clear() { Count = 0; }
+    int size() const { return Count; }
+    bool empty() const { return Count == 0; }
+};
+
+//The rules of a turn on a GameState (the same ones main.cpp plays by)
+class GameEngine
+{
+public:
+    //Start of a game from the dealt hands, the holder of the 3 of clubs leads
+    static GameState newGame(const CardSet hands[GAME_SEATS]);
+    //True once a seat has run out of cards
+    static bool isTerminal(const GameState& state) { return winner(state) >= 0; }
+    //Seat that ran out of cards, -1 while the game goes on
+    static int winner(const GameState& state);
+    //What the seat to move can see of state
+    static TableView viewFor(const GameState& state);
+    //Leading: any combination. Following: the same type and size with a higher rank,
+    //or a pass (the empty set, always listed last).
+    static void legalMoves(const GameState& state, MoveList& out);
+    //Plays move (empty to pass) for the seat to move and hands the turn on
+    static void apply(GameState& state, CardSet move);
+    //apply that can be taken back: records what it changes on undo
+    static void applyMove(GameState& state, CardSet move, UndoStack& undo);
+    //Takes back the newest applyMove of undo, state is exactly as it was before it
+    static void undoMove(GameState& state, UndoStack& undo);
+    //Sets the hand to beat
+    static void setTop(GameState& state, CardSet top);
+    //Deals the cards the seat of view cannot see to the other seats at random,
+    //as many as each of them holds. rng() has to return 64 random bits.
+    template <class Rng>
+    static GameState determinize(CardSet hand, CardSet top, const TableView& view, Rng& rng);
+};
+
+inline GameState GameEngine::newGame(const CardSet hands[GAME_SEATS])
+{
+    GameState state;
+    bool found = false;
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        state.hands[seat] = hands[seat];
+        if (hands[seat].containsIndex(0)) {
+            state.seat = static_cast<uint8_t>(seat);
+            found = true;
+        }
+    }
+    if (!found) {
+        throw invalid_argument("No player has the three of clubs");
+    }
+    return state;
+}
+inline int GameEngine::winner(const GameState& state)
+{
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        if (state.hands[seat].empty()) return seat;
+    }
+    return -1;
+}
+inline TableView GameEngine::viewFor(const GameState& state)
+{
+    TableView view;
+    view.seat = state.seat;
+    view.passes = state.passes;
+    view.played = CardSet::fullDeck();
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        view.handSizes[seat] = state.hands[seat].size();
+        view.played = view.played - state.hands[seat];
+    }
+    return view;
+}
+inline void GameEngine::legalMoves(const GameState& state, MoveList& out)
+{
+    out.clear();
+    CardSet hand = state.hands[state.seat];
+    if (state.top.empty()) {
+        MoveGenerator::generate(hand, out);
+        return;
+    }
+    MoveList candidates;
+    MoveGenerator::generateOfSize(hand, state.top.size(), candidates);
+    uint32_t keys[MoveList::MAX_MOVES];
+    BatchEvaluator::orderKeys(candidates.data(), candidates.size(), keys);
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        if (HandEvaluator::beats(keys[i], state.topKey)) {
+            out.add(candidates[i]);
+        }
+    }
+    out.add(CardSet());
+}
+inline void GameEngine::apply(GameState& state, CardSet move)
+{
+    if (move.empty()) {
+        // Three passes in a row hand the lead back to whoever played last
+        if (++state.passes >= GAME_SEATS - 1) {
+            setTop(state, CardSet());
+        }
+    } else {
+        state.hands[state.seat].remove(move);
+        setTop(state, move);
+    }
+    state.seat = (state.seat + 1) % GAME_SEATS;
+}
+inline void GameEngine::applyMove(GameState& state, CardSet move, UndoStack& undo)
+{
+    undo.push({move, state.top, state.topKey, state.seat, state.passes});
+    apply(state, move);
+}
+inline void GameEngine::undoMove(GameState& state, UndoStack& undo)
+{
+    const UndoRecord& record = undo.pop();
+    state.hands[record.seat].add(record.move);
+    state.top = record.top;
+    state.topKey = record.topKey;
+    state.seat = record.seat;
+    state.passes = record.passes;
+}
+inline void GameEngine::setTop(GameState& state, CardSet top)
+{
+    state.top = top;
+    state.passes = 0;
+    state.topKey = top.empty() ? 0 : HandEvaluator::orderKey(top);
+}
+template <class Rng>
+GameState GameEngine::determinize(CardSet hand, CardSet top, const TableView& view, Rng& rng)
+{
+    uint8_t unseen[CardSet::CARD_COUNT];
+    int count = 0;
+    for (const auto& card : CardSet::fullDeck() - hand - view.played)
+    {
+        unseen[count++] = static_cast<uint8_t>(card.getIndex());
+    }
+
+    int hidden = 0;
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        if (seat != view.seat) hidden += view.handSizes[seat];
+    }
+    if (hidden != count) {
+        throw logic_error("The table view does not account for every card");
+    }
+
+    GameState state;
+    state.hands[view.seat] = hand;
+    setTop(state, top);
+    state.seat = static_cast<uint8_t>(view.seat);
+    state.passes = static_cast<uint8_t>(view.passes);
+    int next = 0;
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        if (seat == view.seat) continue;
+        for (int i = 0; i < view.handSizes[seat]; i++, next++)
+        {
+            swap(unseen[next], unseen[next + static_cast<int>(rng() % (count - next))]);
+            state.hands[seat].addIndex(unseen[next]);
+        }
+    }
+    return state;
+}
+
+#endif
@@ -0,0 +1,378 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+#include "CardSet.h"
+#include "GameEngine.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GAME_RECORD_MMAP 1
+#else
+#define GAME_RECORD_MMAP 0
+#endif
+using namespace std;
+
+//---RECORD FORMAT---
+//A record file is a header followed by one record per game, in any order:
+//  header: "B2GR", format version (1 byte), master seed (8 bytes, little endian)
+//  record: game number (LEB128 varint)
+//          the deal, four 52 bit hands of 7 little endian bytes each (seat 0 first)
+//          one entry per turn: the cards of the play, one byte per card
+//          (CardSet index, RECORD_LAST_CARD set on the last card) or RECORD_PASS
+//          RECORD_END, then the winning seat (RECORD_NO_WINNER if the turn limit was hit)
+//A game of about 60 turns takes around 120 bytes.
+const uint8_t RECORD_VERSION = 1;
+const uint8_t RECORD_LAST_CARD = 0x80;  //Flag on the last card byte of a play
+const uint8_t RECORD_PASS = 0xFF;       //A turn that passed
+const uint8_t RECORD_END = 0xFE;        //Ends the turns of a game, the winner follows
+const uint8_t RECORD_NO_WINNER = 0xFF;
+const int RECORD_HEADER_BYTES = 13;
+const int RECORD_HAND_BYTES = 7;        //52 bits rounded up to whole bytes
+
+//Encodes games into the record format at the end of a byte buffer.
+//Every simulation worker fills its own and hands it to a GameRecordWriter.
+class GameRecordBuffer
+{
+private:
+    vector<uint8_t> bytes;
+
+public:
+    void beginGame(uint64_t game, const CardSet hands[GAME_SEATS]);
+    void addMove(CardSet move);         //An empty move is a pass
+    void endGame(int winner);           //-1 when nobody won
+    const uint8_t* data() const { return bytes.data(); }
+    size_t size() const { return bytes.size(); }
+    void clear() { bytes.clear(); }
+};
+
+//Appends records to a file through a large buffer. write may be called from
+//several threads, every call lands in the file in one piece.
+class GameRecordWriter
+{
+private:
+    static const size_t BUFFER_BYTES = 1 << 20;     //Written to the file once this full
+
+    FILE* file = nullptr;
+    string path;
+    vector<uint8_t> buffer;
+    uint64_t totalBytes = 0;        //Everything handed to the writer, the header included
+    mutex lock;
+
+    void flushLocked();
+
+public:
+    GameRecordWriter(const string& path, uint64_t seed);
+    ~GameRecordWriter();
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    //Adds the records of games and empties games
+    void write(GameRecordBuffer& games);
+    //Writes everything still buffered and closes the file (the destructor does it too)
+    void close();
+    uint64_t bytes() const { return totalBytes; }
+};
+
+//One game of a record file. The turns are left where they are in the file,
+//readTurn decodes them one at a time.
+struct GameRecordView
+{
+    uint64_t game = 0;
+    CardSet hands[GAME_SEATS];
+    const uint8_t* turns = nullptr;     //First turn entry
+    const uint8_t* turnsEnd = nullptr;  //The RECORD_END byte
+    int winner = -1;                    //-1 when nobody won
+
+    //Decodes the turn entry at at into move (empty for a pass) and returns the entry after it
+    const uint8_t* readTurn(const uint8_t* at, CardSet& move) const;
+};
+
+//Walks the records of a range of bytes one game at a time, without copying
+class GameRecordCursor
+{
+private:
+    const uint8_t* at;
+    const uint8_t* end;
+
+public:
+    GameRecordCursor(const uint8_t* begin, const uint8_t* end) : at(begin), end(end) {}
+    //Fills game with the next record, false once the range is used up.
+    //Throws runtime_error when a record is cut short or malformed.
+    bool next(GameRecordView& game);
+    const uint8_t* position() const { return at; }
+};
+
+//A record file opened for reading. It is mapped into memory where the system
+//allows it (read whole otherwise), so the records are decoded in place.
+class GameRecordFile
+{
+private:
+    const uint8_t* base = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    vector<uint8_t> contents;       //The file when it could not be mapped
+    uint64_t seed = 0;
+
+    void unmap();
+
+public:
+    explicit GameRecordFile(const string& path);
+    ~GameRecordFile();
+    GameRecordFile(const GameRecordFile&) = delete;
+    GameRecordFile& operator=(const GameRecordFile&) = delete;
+
+    uint64_t getSeed() const { return seed; }
+    size_t size() const { return length; }
+    //The records, the header left out
+    const uint8_t* recordsBegin() const { return base + RECORD_HEADER_BYTES; }
+    const uint8_t* recordsEnd() const { return base + length; }
+    GameRecordCursor records() const { return GameRecordCursor(recordsBegin(), recordsEnd()); }
+};
+
+//---BUFFER---
+inline void GameRecordBuffer::beginGame(uint64_t game, const CardSet hands[GAME_SEATS])
+{
+    // Seven bits per byte, the high bit says another byte follows
+    while (game >= 0x80)
+    {
+        bytes.push_back(static_cast<uint8_t>(game | 0x80));
+        game >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(game));
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        uint64_t mask = hands[seat].getMask();
+        for (int i = 0; i < RECORD_HAND_BYTES; i++)
+        {
+            bytes.push_back(static_cast<uint8_t>(mask >> (8 * i)));
+        }
+    }
+}
+inline void GameRecordBuffer::addMove(CardSet move)
+{
+    if (move.empty()) {
+        bytes.push_back(RECORD_PASS);
+        return;
+    }
+    for (uint64_t rest = move.getMask(); rest != 0; rest &= rest - 1)
+    {
+        uint8_t card = static_cast<uint8_t>(lowestBit64(rest));
+        bytes.push_back((rest & (rest - 1)) == 0 ? card | RECORD_LAST_CARD : card);
+    }
+}
+inline void GameRecordBuffer::endGame(int winner)
+{
+    bytes.push_back(RECORD_END);
+    bytes.push_back(winner >= 0 ? static_cast<uint8_t>(winner) : RECORD_NO_WINNER);
+}
+
+//---WRITER---
+inline GameRecordWriter::GameRecordWriter(const string& filePath, uint64_t seed)
+    : path(filePath)
+{
+    file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw runtime_error("Cannot open record file " + path);
+    }
+    buffer.reserve(BUFFER_BYTES);
+    const uint8_t magic[4] = {'B', '2', 'G', 'R'};
+    buffer.insert(buffer.end(), magic, magic + 4);
+    buffer.push_back(RECORD_VERSION);
+    for (int i = 0; i < 8; i++)
+    {
+        buffer.push_back(static_cast<uint8_t>(seed >> (8 * i)));
+    }
+    totalBytes = buffer.size();
+}
+inline GameRecordWriter::~GameRecordWriter()
+{
+    try {
+        close();
+    } catch (const exception&) {
+        // Destructors must not throw, call close to see the error
+    }
+}
+inline void GameRecordWriter::flushLocked()
+{
+    if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        throw runtime_error("Cannot write to record file " + path);
+    }
+    buffer.clear();
+}
+inline void GameRecordWriter::write(GameRecordBuffer& games)
+{
+    lock_guard<mutex> guard(lock);
+    if (file == nullptr) {
+        throw logic_error("Record file " + path + " is already closed");
+    }
+    totalBytes += games.size();
+    if (buffer.size() + games.size() > BUFFER_BYTES) {
+        flushLocked();
+    }
+    // Bigger than the whole buffer: straight to the file
+    if (games.size() > BUFFER_BYTES) {
+        if (fwrite(games.data(), 1, games.size(), file) != games.size()) {
+            throw runtime_error("Cannot write to record file " + path);
+        }
+    } else {
+        buffer.insert(buffer.end(), games.data(), games.data() + games.size());
+    }
+    games.clear();
+}
+inline void GameRecordWriter::close()
+{
+    lock_guard<mutex> guard(lock);
+    if (file == nullptr) {
+        return;
+    }
+    flushLocked();
+    bool failed = fclose(file) != 0;
+    file = nullptr;
+    if (failed) {
+        throw runtime_error("Cannot close record file " + path);
+    }
+}
+
+//---READER---
+inline const uint8_t* GameRecordView::readTurn(const uint8_t* at, CardSet& move) const
+{
+    move = CardSet();
+    if (*at == RECORD_PASS) {
+        return at + 1;
+    }
+    while (at < turnsEnd)
+    {
+        uint8_t entry = *at++;
+        uint8_t card = entry & ~RECORD_LAST_CARD;
+        if (card >= CardSet::CARD_COUNT) {
+            break;
+        }
+        move.addIndex(card);
+        if (entry & RECORD_LAST_CARD) {
+            return at;
+        }
+    }
+    throw runtime_error("Malformed turn in the record of game " + to_string(game));
+}
+inline bool GameRecordCursor::next(GameRecordView& game)
+{
+    if (at == end) {
+        return false;
+    }
+    const uint8_t* p = at;
+    uint64_t number = 0;
+    for (int shift = 0; ; shift += 7)
+    {
+        if (p == end || shift > 63) {
+            throw runtime_error("Game record is cut short");
+        }
+        uint8_t byte = *p++;
+        number |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) break;
+    }
+    if (end - p < GAME_SEATS * RECORD_HAND_BYTES) {
+        throw runtime_error("Game record is cut short");
+    }
+    game.game = number;
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        uint64_t mask = 0;
+        for (int i = 0; i < RECORD_HAND_BYTES; i++)
+        {
+            mask |= static_cast<uint64_t>(*p++) << (8 * i);
+        }
+        game.hands[seat] = CardSet(mask);
+    }
+    // Neither a card nor a pass can be RECORD_END, so the first one closes the turns
+    const uint8_t* close = static_cast<const uint8_t*>(memchr(p, RECORD_END, end - p));
+    if (close == nullptr || end - close < 2) {
+        throw runtime_error("Game record is cut short");
+    }
+    uint8_t winner = close[1];
+    if (winner >= GAME_SEATS && winner != RECORD_NO_WINNER) {
+        throw runtime_error("Bad winner in the record of game " + to_string(number));
+    }
+    game.turns = p;
+    game.turnsEnd = close;
+    game.winner = winner == RECORD_NO_WINNER ? -1 : winner;
+    at = close + 2;
+    return true;
+}
+inline GameRecordFile::GameRecordFile(const string& path)
+{
+#if GAME_RECORD_MMAP
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw runtime_error("Cannot open record file " + path);
+    }
+    struct stat info;
+    if (fstat(descriptor, &info) == 0 && info.st_size >= RECORD_HEADER_BYTES) {
+        void* view = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (view != MAP_FAILED) {
+            // The readers go front to back, let the kernel read ahead
+            madvise(view, info.st_size, MADV_SEQUENTIAL);
+            base = static_cast<const uint8_t*>(view);
+            length = static_cast<size_t>(info.st_size);
+            mapped = true;
+        }
+    }
+    ::close(descriptor);
+#endif
+    if (!mapped) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            throw runtime_error("Cannot open record file " + path);
+        }
+        uint8_t block[1 << 16];
+        size_t got;
+        while ((got = fread(block, 1, sizeof(block), file)) > 0)
+        {
+            contents.insert(contents.end(), block, block + got);
+        }
+        bool failed = ferror(file) != 0;
+        fclose(file);
+        if (failed) {
+            throw runtime_error("Cannot read record file " + path);
+        }
+        base = contents.data();
+        length = contents.size();
+    }
+
+    const uint8_t magic[4] = {'B', '2', 'G', 'R'};
+    if (length < static_cast<size_t>(RECORD_HEADER_BYTES) || memcmp(base, magic, 4) != 0) {
+        unmap();
+        throw runtime_error(path + " is not a game record file");
+    }
+    if (base[4] != RECORD_VERSION) {
+        unmap();
+        throw runtime_error(path + " has record format version " + to_string(base[4]) +
+                            ", this build reads version " + to_string(RECORD_VERSION));
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        seed |= static_cast<uint64_t>(base[5 + i]) << (8 * i);
+    }
+}
+inline GameRecordFile::~GameRecordFile()
+{
+    unmap();
+}
+inline void GameRecordFile::unmap()
+{
+#if GAME_RECORD_MMAP
+    if (mapped) {
+        munmap(const_cast<uint8_t*>(base), length);
+        mapped = false;
+    }
+#endif
+}
+
+#endif
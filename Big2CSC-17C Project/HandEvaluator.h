@@ -0,0 +1,168 @@
+#ifndef HANDEVALUATOR_H
+#define HANDEVALUATOR_H
+#include "CardSet.h"
+#include <array>
+#include <cstdint>
+using namespace std;
+
+//Result of classifying a set of cards, same meaning as the PlayingHand fields
+struct HandEvaluation
+{
+    int handType;           //Hand type singles, royal flush      (0-10)
+    int highestCardRank;    //Highest card rank (when applicable) (1-13, -1 otherwise)
+    int highestHandSuit;    //Highest hand suit (when applicable) (1-4, -1 otherwise)
+};
+
+//Classifies hands with a handful of bit operations and one table lookup.
+//The rank multiset of the hand is reduced to a shape key (card count, amount of
+//pairs, trips, quads, flush, straight, ace high straight) and SHAPE_TYPE maps
+//every key to the hand type the old isRoyalFlush ... isHighCard chain returned.
+class HandEvaluator
+{
+    friend class BatchEvaluator;    //Runs the same steps on several hands at once
+private:
+    //---SHAPE KEY LAYOUT---
+    static constexpr int KEY_COUNT_BITS = 3;    //Card count, anything above 5 is stored as 6
+    static constexpr int KEY_PAIRS_SHIFT = 3;   //Ranks held at least twice (0-3)
+    static constexpr int KEY_TRIP_SHIFT = 5;    //A rank is held at least three times
+    static constexpr int KEY_QUAD_SHIFT = 6;    //A rank is held four times
+    static constexpr int KEY_FLUSH_SHIFT = 7;   //Five cards of one suit
+    static constexpr int KEY_STRAIGHT_SHIFT = 8;//Five consecutive ranks
+    static constexpr int KEY_ROYAL_SHIFT = 9;   //Straight ending on the ace (10 J Q K A)
+    static constexpr int SHAPE_COUNT = 1 << 10;
+
+    static constexpr uint64_t NIBBLE_LOW = 0x1111111111111ULL;  //Lowest bit of every rank nibble
+
+    //Builds the type of every shape key, following the rules of the old evaluation chain
+    static constexpr array<uint8_t, SHAPE_COUNT> buildShapeTable()
+    {
+        array<uint8_t, SHAPE_COUNT> table = {};
+        for (int key = 0; key < SHAPE_COUNT; key++)
+        {
+            int count = key & ((1 << KEY_COUNT_BITS) - 1);
+            int pairs = (key >> KEY_PAIRS_SHIFT) & 3;
+            bool trip = (key >> KEY_TRIP_SHIFT) & 1;
+            bool quad = (key >> KEY_QUAD_SHIFT) & 1;
+            bool flush = (key >> KEY_FLUSH_SHIFT) & 1;
+            bool straight = (key >> KEY_STRAIGHT_SHIFT) & 1;
+            bool royal = (key >> KEY_ROYAL_SHIFT) & 1;
+            uint8_t type = 0;
+            switch (count)
+            {
+                case 1: type = 1; break;                                // High Card
+                case 2: type = pairs == 1 ? 2 : 0; break;               // Pair
+                case 3: type = trip ? 4 : 0; break;                     // Three of a Kind
+                case 4: type = (pairs == 2 && !trip) ? 3 : 0; break;    // Two Pair
+                case 5:
+                    if (straight && flush) type = royal ? 10 : 9;       // Royal / Straight Flush
+                    else if (quad) type = 8;                            // Four of a Kind
+                    else if (trip && pairs == 2) type = 7;              // Full House
+                    else if (flush) type = 6;                           // Flush
+                    else if (straight) type = 5;                        // Straight
+                    break;
+                default: type = 0; break;
+            }
+            table[key] = type;
+        }
+        return table;
+    }
+
+    static const array<uint8_t, SHAPE_COUNT> SHAPE_TYPE;   //Hand type of every shape key
+
+    //Hand types whose rank is the highest rank held more than once
+    static constexpr bool rankFromGroups(int type)
+    {
+        return type == 2 || type == 3 || type == 4 || type == 7 || type == 8;
+    }
+
+    //Packs the lowest bit of every rank nibble into a 13 bit rank mask
+    static uint32_t gatherRanks(uint64_t flags)
+    {
+        uint64_t x = flags | (flags >> 3) | (flags >> 6) | (flags >> 9);
+        return static_cast<uint32_t>((x & 0xF) | ((x >> 12) & 0xF0) |
+                                     ((x >> 24) & 0xF00) | ((x >> 36) & 0xF000));
+    }
+
+public:
+    static HandEvaluation evaluate(CardSet hand);
+
+    //---ORDER KEYS---
+    //Every play packed into one integer: type << 12 | size << 8 | rank << 4 | suit
+    //(rank and suit are 0 when the hand has none). Keys sort like PlayingHand's
+    //operator< (the size of a playable type never varies), and a play beats
+    //another exactly when the type and size match and the rank is higher, which
+    //is one unsigned range check on the key.
+    static uint32_t orderKey(const HandEvaluation& eval, int size);
+    static uint32_t orderKey(CardSet hand) { return orderKey(evaluate(hand), hand.size()); }
+    static int typeOf(uint32_t key) { return static_cast<int>(key >> 12); }
+    static int sizeOf(uint32_t key) { return static_cast<int>((key >> 8) & 0xF); }
+    static int rankOf(uint32_t key) { return static_cast<int>((key >> 4) & 0xF); }
+    static int suitOf(uint32_t key) { return static_cast<int>(key & 0xF); }
+    //True when the play of key may follow the play of topKey
+    static bool beats(uint32_t key, uint32_t topKey)
+    {
+        // The keys of the same type and size with a higher rank run from low to high
+        uint32_t low = (topKey | 0xF) + 1;
+        uint32_t high = topKey | 0xFF;
+        return key - low <= high - low;
+    }
+};
+
+//Built at compile time
+inline constexpr array<uint8_t, HandEvaluator::SHAPE_COUNT> HandEvaluator::SHAPE_TYPE = HandEvaluator::buildShapeTable();
+
+//Evaluates the hand type, highest card rank and highest suit of a set of cards
+inline HandEvaluation HandEvaluator::evaluate(CardSet hand)
+{
+    uint64_t mask = hand.getMask();
+    if (mask == 0) {
+        return {0, -1, -1};
+    }
+    int count = popCount64(mask);
+
+    //Highest suit count wins, ties go to the higher suit
+    int bestSuitKey = 0;
+    for (int suit = 0; suit < 4; suit++)
+    {
+        int suitKey = (popCount64(mask & (CardSet::SUIT_MASK << suit)) << 2) | suit;
+        bestSuitKey = suitKey > bestSuitKey ? suitKey : bestSuitKey;
+    }
+    int highestSuit = (bestSuitKey & 3) + 1;
+    bool flush = count == 5 && (bestSuitKey >> 2) == 5;
+
+    //Amount of cards of every rank, one nibble per rank (0-4)
+    uint64_t perRank = mask - ((mask >> 1) & 0x5555555555555555ULL);
+    perRank = (perRank & 0x3333333333333333ULL) + ((perRank >> 2) & 0x3333333333333333ULL);
+
+    uint32_t distinct = gatherRanks((perRank | (perRank >> 1) | (perRank >> 2)) & NIBBLE_LOW);
+    uint32_t grouped = gatherRanks(((perRank >> 1) | (perRank >> 2)) & NIBBLE_LOW);
+    uint32_t tripled = gatherRanks(((perRank >> 2) | ((perRank >> 1) & perRank)) & NIBBLE_LOW);
+    uint32_t quadded = gatherRanks((perRank >> 2) & NIBBLE_LOW);
+
+    int lowestRank = lowestBit64(distinct);
+    bool straight = count == 5 && distinct == (0x1Fu << lowestRank);
+    bool royal = straight && lowestRank == 7;
+
+    int key = (count > 5 ? 6 : count) |
+              ((popCount64(grouped) > 3 ? 3 : popCount64(grouped)) << KEY_PAIRS_SHIFT) |
+              ((tripled != 0) << KEY_TRIP_SHIFT) |
+              ((quadded != 0) << KEY_QUAD_SHIFT) |
+              (flush << KEY_FLUSH_SHIFT) |
+              (straight << KEY_STRAIGHT_SHIFT) |
+              (royal << KEY_ROYAL_SHIFT);
+    int type = SHAPE_TYPE[key];
+    if (type == 0) {
+        return {0, -1, highestSuit};
+    }
+    int rank = highestBit64(rankFromGroups(type) ? grouped : distinct) + 1;
+    return {type, rank, highestSuit};
+}
+inline uint32_t HandEvaluator::orderKey(const HandEvaluation& eval, int size)
+{
+    uint32_t rank = eval.highestCardRank > 0 ? eval.highestCardRank : 0;
+    uint32_t suit = eval.highestHandSuit > 0 ? eval.highestHandSuit : 0;
+    uint32_t cards = size < 15 ? static_cast<uint32_t>(size) : 15;    //Only invalid hands hold more
+    return (static_cast<uint32_t>(eval.handType) << 12) | (cards << 8) | (rank << 4) | suit;
+}
+
+#endif
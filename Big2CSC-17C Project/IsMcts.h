@@ -0,0 +1,325 @@
+#ifndef ISMCTS_H
+#define ISMCTS_H
+#include "GameEngine.h"
+#include "Random.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+using namespace std;
+
+//Budget of one move. The search stops at whichever limit is reached first,
+//0 turns a limit off (one of them has to stay on).
+struct MctsConfig
+{
+    int iterations = 2000;          //Determinized playouts per move
+    double seconds = 0;             //Time per move
+    int threads = 1;                //Independent trees searched at once and merged at the root
+    int maxNodes = 1 << 16;         //Nodes per tree, playouts go on without expanding once it is full
+    double exploration = 0.7;       //UCB exploration constant
+    bool moveArena = true;          //Temporaries of a move come from the search's arena (false: the default allocator)
+};
+
+//What the last search did
+struct MctsSearchStats
+{
+    long long iterations = 0;
+    double seconds = 0;
+    double iterationsPerSecond() const { return seconds > 0 ? iterations / seconds : 0; }
+};
+
+//Single observer information set Monte Carlo tree search (SO-ISMCTS).
+//Every iteration deals the cards the deciding seat cannot see to the other
+//seats at random (a determinization), walks the shared tree with the moves
+//that are legal in that deal, adds one node and finishes the game with random
+//legal moves. A node counts how often it was available as well as visited so
+//moves that only exist in some deals are not favoured.
+//With more than one thread every thread grows its own tree (root
+//parallelism) and the root visits are added together.
+class IsMctsSearch
+{
+private:
+    struct Node
+    {
+        CardSet move;           //Play that leads here, empty for a pass
+        int parent;
+        int mover;              //Seat that made the move (-1 at the root)
+        int visits;
+        int available;          //Iterations in which the move was legal at its parent
+        double wins;            //Iterations won by mover
+    };
+
+    //One search tree, children are found through an open addressing table keyed by (parent, move)
+    struct Tree
+    {
+        vector<Node> nodes;
+        vector<int> slots;      //Node index or -1
+        uint64_t slotMask = 0;
+        vector<int> path;
+        MoveList moves;
+        long long iterations = 0;
+
+        void reset(int maxNodes);
+        int find(int parent, CardSet move) const;
+        int add(int parent, CardSet move, int mover);
+        static uint64_t slotOf(int parent, CardSet move);
+    };
+
+    static const size_t ARENA_BYTES = 16 << 10;    //Enough for the temporaries of a move with room to spare
+    static const int MAX_DEPTH = 256;   //Longer than any game: at most 49 plays, each followed by up to 3 passes
+
+    MctsConfig config;
+    vector<Tree> trees;         //Sized for the node limit up front and kept from move to move
+    vector<unsigned char> arenaBuffer;  //Memory of the arena of every move
+    MctsSearchStats stats;
+
+    static int randomBelow(Xoshiro256& rng, int count) { return static_cast<int>(rng.below(count)); }
+    int nodeLimit() const;
+    void iterate(Tree& tree, const GameState& root, Xoshiro256& rng) const;
+    void searchTree(Tree& tree, CardSet hand, CardSet top, const TableView& view, uint64_t seed) const;
+
+public:
+    explicit IsMctsSearch(const MctsConfig& config);
+
+    //Picks the play for view.seat holding hand against top (empty to lead).
+    //Returns the cards to play, an empty set to pass. The same seed and an
+    //iteration only budget always give the same move.
+    CardSet chooseMove(CardSet hand, CardSet top, const TableView& view, uint64_t seed);
+    const MctsSearchStats& lastSearch() const { return stats; }
+    const MctsConfig& getConfig() const { return config; }
+};
+
+inline IsMctsSearch::IsMctsSearch(const MctsConfig& settings)
+    : config(settings)
+{
+    if (config.iterations <= 0 && config.seconds <= 0) {
+        throw invalid_argument("An MCTS budget needs an iteration or a time limit");
+    }
+    if (config.threads < 1) config.threads = 1;
+    if (config.maxNodes < 2) config.maxNodes = 2;
+    trees.resize(config.threads);
+    // Every tree gets all its memory now, so no move (not even the first) asks the heap for it
+    for (auto& tree : trees)
+    {
+        tree.reset(nodeLimit());
+    }
+    arenaBuffer.resize(ARENA_BYTES);
+}
+//Nodes a tree can need: one per iteration and the root, at most maxNodes
+inline int IsMctsSearch::nodeLimit() const
+{
+    if (config.iterations > 0 && config.iterations + 1 < config.maxNodes) {
+        return config.iterations + 1;
+    }
+    return config.maxNodes;
+}
+
+//---TREE---
+inline void IsMctsSearch::Tree::reset(int maxNodes)
+{
+    uint64_t slotCount = 2;
+    while (slotCount < 2 * static_cast<uint64_t>(maxNodes)) slotCount *= 2;
+    slots.assign(slotCount, -1);
+    slotMask = slotCount - 1;
+    nodes.clear();
+    nodes.reserve(maxNodes);
+    nodes.push_back({CardSet(), -1, -1, 0, 0, 0});
+    path.reserve(MAX_DEPTH);
+    iterations = 0;
+}
+inline uint64_t IsMctsSearch::Tree::slotOf(int parent, CardSet move)
+{
+    uint64_t key = move.getMask() ^ (static_cast<uint64_t>(parent) << 52) ^ static_cast<uint64_t>(parent);
+    key *= 0x9E3779B97F4A7C15ULL;
+    return key ^ (key >> 29);
+}
+inline int IsMctsSearch::Tree::find(int parent, CardSet move) const
+{
+    for (uint64_t slot = slotOf(parent, move) & slotMask; ; slot = (slot + 1) & slotMask)
+    {
+        int index = slots[slot];
+        if (index < 0) return -1;
+        if (nodes[index].parent == parent && nodes[index].move == move) return index;
+    }
+}
+inline int IsMctsSearch::Tree::add(int parent, CardSet move, int mover)
+{
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back({move, parent, mover, 0, 0, 0});
+    uint64_t slot = slotOf(parent, move) & slotMask;
+    while (slots[slot] >= 0) slot = (slot + 1) & slotMask;
+    slots[slot] = index;
+    return index;
+}
+
+//---SEARCH---
+inline void IsMctsSearch::iterate(Tree& tree, const GameState& root, Xoshiro256& rng) const
+{
+    GameState state = root;
+    int node = 0;
+    int winner = -1;
+    tree.path.clear();
+    tree.path.push_back(0);
+
+    // Selection and expansion, only over the moves legal in this deal
+    while (true)
+    {
+        GameEngine::legalMoves(state, tree.moves);
+        int best = -1;
+        double bestScore = -1;
+        int untried = 0;
+        CardSet untriedMove;
+        for (const auto& move : tree.moves)
+        {
+            int child = tree.find(node, move);
+            if (child < 0) {
+                // Reservoir sample one of the moves without a node yet
+                if (randomBelow(rng, ++untried) == 0) untriedMove = move;
+                continue;
+            }
+            Node& n = tree.nodes[child];
+            n.available++;
+            double score = n.wins / n.visits +
+                config.exploration * sqrt(log(static_cast<double>(n.available)) / n.visits);
+            if (score > bestScore) {
+                bestScore = score;
+                best = child;
+            }
+        }
+
+        CardSet move;
+        if (untried > 0) {
+            if (static_cast<int>(tree.nodes.size()) >= config.maxNodes) {
+                break;
+            }
+            move = untriedMove;
+            node = tree.add(node, move, state.seat);
+            tree.nodes[node].available = 1;
+        } else {
+            node = best;
+            move = tree.nodes[node].move;
+        }
+        int mover = state.seat;
+        GameEngine::apply(state, move);
+        tree.path.push_back(node);
+        if (state.hands[mover].empty()) {
+            winner = mover;
+        }
+        if (winner >= 0 || untried > 0) {
+            break;
+        }
+    }
+
+    // Random playout to the end of the game
+    while (winner < 0)
+    {
+        GameEngine::legalMoves(state, tree.moves);
+        int mover = state.seat;
+        GameEngine::apply(state, tree.moves[randomBelow(rng, tree.moves.size())]);
+        if (state.hands[mover].empty()) {
+            winner = mover;
+        }
+    }
+
+    for (int index : tree.path)
+    {
+        Node& n = tree.nodes[index];
+        n.visits++;
+        if (n.mover == winner) {
+            n.wins += 1;
+        }
+    }
+    tree.iterations++;
+}
+inline void IsMctsSearch::searchTree(Tree& tree, CardSet hand, CardSet top, const TableView& view,
+                                     uint64_t seed) const
+{
+    Xoshiro256 rng(seed);
+    tree.reset(nodeLimit());
+
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(
+        chrono::duration<double>(config.seconds));
+    for (long long i = 0; config.iterations <= 0 || i < config.iterations; i++)
+    {
+        // Looking at the clock every iteration would cost more than a shallow playout
+        if (config.seconds > 0 && (i & 31) == 0 && i > 0 && chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        iterate(tree, GameEngine::determinize(hand, top, view, rng), rng);
+    }
+}
+inline CardSet IsMctsSearch::chooseMove(CardSet hand, CardSet top, const TableView& view, uint64_t seed)
+{
+    auto start = chrono::steady_clock::now();
+    stats = MctsSearchStats();
+
+    // Nothing to think about with a single choice
+    GameState rootState;
+    rootState.seat = static_cast<uint8_t>(view.seat);
+    rootState.hands[view.seat] = hand;
+    GameEngine::setTop(rootState, top);
+    GameEngine::legalMoves(rootState, trees[0].moves);
+    CardSet bestMove = trees[0].moves[0];
+    if (trees[0].moves.size() == 1) {
+        return bestMove;
+    }
+
+    // The lists below only live for this move: they are carved out of arenaBuffer
+    // one after the other and all handed back at once when the arena goes out of
+    // scope (the heap is only asked if the buffer runs out). Starting a helper
+    // thread still allocates its start state inside std::thread.
+    pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size());
+    pmr::memory_resource* memory = config.moveArena ? static_cast<pmr::memory_resource*>(&arena)
+                                                    : pmr::new_delete_resource();
+
+    pmr::vector<thread> helpers(memory);
+    for (int t = 1; t < config.threads; t++)
+    {
+        helpers.emplace_back([this, t, hand, top, &view, seed]() {
+            searchTree(trees[t], hand, top, view, seed + 0x9E3779B97F4A7C15ULL * t);
+        });
+    }
+    searchTree(trees[0], hand, top, view, seed);
+    for (auto& helper : helpers)
+    {
+        helper.join();
+    }
+
+    // Add the root visits of every tree together, the most visited move wins
+    pmr::vector<pair<CardSet, long long>> totals(memory);
+    for (const auto& tree : trees)
+    {
+        stats.iterations += tree.iterations;
+        for (const auto& node : tree.nodes)
+        {
+            if (node.parent != 0) continue;
+            bool merged = false;
+            for (auto& total : totals)
+            {
+                if (total.first == node.move) {
+                    total.second += node.visits;
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged) totals.emplace_back(node.move, node.visits);
+        }
+    }
+    long long bestVisits = -1;
+    for (const auto& total : totals)
+    {
+        if (total.second > bestVisits) {
+            bestVisits = total.second;
+            bestMove = total.first;
+        }
+    }
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return bestMove;
+}
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+#include <iostream>
+using namespace std;
+
+//Wall time of the hot paths, built in with -DBIG2_LATENCY=1. Without it
+//LATENCY_SCOPE expands to nothing and printLatencyReport does nothing, so a
+//normal build has no trace of the timers.
+#ifndef BIG2_LATENCY
+#define BIG2_LATENCY 0
+#endif
+
+//What is timed
+enum class LatencyProbe
+{
+    Turn,               //A whole turn of the game loop (main.cpp, Simulation.h)
+    Decision,           //Player::decision
+    AiTurn,             //Player::aiTurn
+    FindBestHand,       //Player::findBestHand
+    EvaluateHand        //PlayingHand::evaluateHand
+};
+const int LATENCY_PROBES = 5;
+
+#if BIG2_LATENCY
+#include "CardSet.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//Counts of nanosecond values in log linear buckets (the HDR histogram layout):
+//values below 16 get a bucket each, above that every power of two is split
+//into 16 buckets, so a bucket is never wider than 1/16 of its values.
+//Only the thread that owns a histogram writes it; the counters are atomics
+//written with plain loads and stores so a report can read them at any time
+//without locks or read-modify-write instructions on the hot path.
+class LatencyHistogram
+{
+public:
+    static const int SUB_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    static int bucketOf(uint64_t ns)
+    {
+        if (ns < SUB_BUCKETS) {
+            return static_cast<int>(ns);
+        }
+        int exponent = highestBit64(ns);
+        int shift = exponent - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<int>((ns >> shift) & (SUB_BUCKETS - 1));
+    }
+    //Highest value that lands in bucket
+    static uint64_t highestIn(int bucket)
+    {
+        if (bucket < SUB_BUCKETS) {
+            return static_cast<uint64_t>(bucket);
+        }
+        int shift = bucket / SUB_BUCKETS - 1;
+        uint64_t low = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return low + (uint64_t(1) << shift) - 1;
+    }
+
+    void record(uint64_t ns)
+    {
+        bump(counts[bucketOf(ns)], 1);
+        bump(total, 1);
+        if (ns > largest.load(memory_order_relaxed)) {
+            largest.store(ns, memory_order_relaxed);
+        }
+    }
+
+    //Plain copy of one or more histograms added together
+    struct Snapshot
+    {
+        uint64_t counts[BUCKETS] = {};
+        uint64_t total = 0;
+        uint64_t largest = 0;
+
+        //Nearest rank percentile: the ceil(q * count)th smallest value, rounded up to
+        //the top of its bucket (at most 1/16 above it) and never above the largest
+        uint64_t percentile(double q) const;
+    };
+    void addTo(Snapshot& snapshot) const;
+
+private:
+    atomic<uint64_t> counts[BUCKETS] = {};
+    atomic<uint64_t> total{0};
+    atomic<uint64_t> largest{0};
+
+    static void bump(atomic<uint64_t>& counter, uint64_t amount)
+    {
+        counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+};
+
+//The histograms of every thread that has timed anything. A thread finds its
+//own through a thread_local pointer; they are never freed, so the numbers of
+//finished simulation workers stay in the report.
+class LatencyRegistry
+{
+private:
+    struct ThreadHistograms
+    {
+        LatencyHistogram probes[LATENCY_PROBES];
+    };
+
+    mutex lock;                                 //Only taken when a thread times its first call and by reports
+    vector<unique_ptr<ThreadHistograms>> threads;
+
+    static LatencyRegistry& instance()
+    {
+        static LatencyRegistry registry;
+        return registry;
+    }
+
+public:
+    //The histogram of probe for the calling thread
+    static LatencyHistogram& local(LatencyProbe probe)
+    {
+        static thread_local ThreadHistograms* mine = nullptr;
+        if (mine == nullptr) {
+            LatencyRegistry& registry = instance();
+            lock_guard<mutex> guard(registry.lock);
+            registry.threads.push_back(make_unique<ThreadHistograms>());
+            mine = registry.threads.back().get();
+        }
+        return mine->probes[static_cast<int>(probe)];
+    }
+    //Every thread's histogram of probe added together
+    static LatencyHistogram::Snapshot snapshot(LatencyProbe probe)
+    {
+        LatencyRegistry& registry = instance();
+        lock_guard<mutex> guard(registry.lock);
+        LatencyHistogram::Snapshot result;
+        for (const auto& histograms : registry.threads)
+        {
+            histograms->probes[static_cast<int>(probe)].addTo(result);
+        }
+        return result;
+    }
+};
+
+//Records the time from its construction to the end of the scope
+class LatencyTimer
+{
+private:
+    LatencyProbe probe;
+    chrono::steady_clock::time_point start;
+
+public:
+    explicit LatencyTimer(LatencyProbe probe) : probe(probe), start(chrono::steady_clock::now()) {}
+    ~LatencyTimer()
+    {
+        auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+        LatencyRegistry::local(probe).record(static_cast<uint64_t>(elapsed.count()));
+    }
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+};
+
+inline void LatencyHistogram::addTo(Snapshot& snapshot) const
+{
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        snapshot.counts[i] += counts[i].load(memory_order_relaxed);
+    }
+    snapshot.total += total.load(memory_order_relaxed);
+    uint64_t most = largest.load(memory_order_relaxed);
+    if (most > snapshot.largest) snapshot.largest = most;
+}
+inline uint64_t LatencyHistogram::Snapshot::percentile(double q) const
+{
+    // The bucket counts of a running thread may be a few calls ahead of or behind its total
+    uint64_t all = 0;
+    for (uint64_t count : counts) all += count;
+    if (all == 0) {
+        return 0;
+    }
+    // The small margin keeps a product like 0.07 * 100 = 7.000000000000001 at rank 7
+    uint64_t wanted = static_cast<uint64_t>(ceil(q * static_cast<double>(all) - 1e-9));
+    if (wanted < 1) wanted = 1;
+    if (wanted > all) wanted = all;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        seen += counts[i];
+        if (seen >= wanted) {
+            uint64_t value = highestIn(i);
+            return value < largest ? value : largest;
+        }
+    }
+    return largest;
+}
+
+#define LATENCY_SCOPE(probe) LatencyTimer latencyTimer(probe)
+
+//Prints count, p50, p99, p999 and max of every probe (in microseconds). Can
+//be called at any time from any thread, the threads being timed go on as usual.
+inline void printLatencyReport(ostream& out)
+{
+    static const char* const NAMES[LATENCY_PROBES] = {"turn", "decision", "aiTurn", "findBestHand", "evaluateHand"};
+    ios_base::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << fixed << setprecision(3);
+    out << "latency (us)          count        p50        p99       p999        max\n";
+    for (int i = 0; i < LATENCY_PROBES; i++)
+    {
+        LatencyHistogram::Snapshot s = LatencyRegistry::snapshot(static_cast<LatencyProbe>(i));
+        out << left << setw(14) << NAMES[i] << right << setw(13) << s.total
+            << setw(11) << s.percentile(0.5) / 1e3 << setw(11) << s.percentile(0.99) / 1e3
+            << setw(11) << s.percentile(0.999) / 1e3 << setw(11) << s.largest / 1e3 << '\n';
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+#else
+#define LATENCY_SCOPE(probe)
+inline void printLatencyReport(ostream&) {}
+#endif
+
+#endif
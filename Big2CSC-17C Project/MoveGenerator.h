@@ -0,0 +1,260 @@
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+#include "CardSet.h"
+#include <cstdint>
+#include <stdexcept>
+using namespace std;
+
+//Fixed size list of candidate plays, each stored as the set of cards it uses
+class MoveList
+{
+public:
+    //Enough for every legal play of a 13 card hand (1287 five card subsets at most,
+    //plus singles, pairs, triples and two pairs)
+    static const int MAX_MOVES = 1536;
+
+private:
+    uint64_t Moves[MAX_MOVES];  //Raw masks, left uninitialized so a list costs nothing to create
+    int Count = 0;
+
+public:
+    //Walks the moves as CardSets
+    class iterator
+    {
+    private:
+        const uint64_t* at;
+    public:
+        explicit iterator(const uint64_t* position) : at(position) {}
+        CardSet operator*() const { return CardSet(*at); }
+        iterator& operator++() { ++at; return *this; }
+        bool operator!=(const iterator& other) const { return at != other.at; }
+        bool operator==(const iterator& other) const { return at == other.at; }
+    };
+
+    void add(CardSet move)
+    {
+        if (Count == MAX_MOVES) {
+            throw length_error("Move list is full");
+        }
+        Moves[Count++] = move.getMask();
+    }
+    void clear() { Count = 0; }
+    int size() const { return Count; }
+    bool empty() const { return Count == 0; }
+    CardSet operator[](int I) const { return CardSet(Moves[I]); }
+    const uint64_t* data() const { return Moves; }     //The masks, for batch evaluation
+    iterator begin() const { return iterator(Moves); }
+    iterator end() const { return iterator(Moves + Count); }
+};
+
+//Lists the legal plays of a hand straight from its rank nibbles and suit masks
+//instead of trying every subset of the cards:
+//  1 card  - singles
+//  2 cards - pairs
+//  3 cards - three of a kind
+//  4 cards - two pairs
+//  5 cards - straights (and straight / royal flushes), flushes, full houses,
+//            four of a kind plus a kicker
+//Every play is listed once.
+class MoveGenerator
+{
+private:
+    static uint64_t rankBits(uint64_t mask, int rank) { return (mask >> ((rank - 1) * 4)) & 0xF; }
+
+    static void addOfSize(uint64_t mask, int cardCount, MoveList& out);
+    //Writes every k card subset of one rank (nibble) into groups, returns how many
+    static int findGroups(uint64_t mask, int cardsPerGroup, uint64_t* groups);
+    static void addGroups(uint64_t mask, int cardsPerGroup, MoveList& out);
+    static void addTwoPairs(uint64_t mask, MoveList& out);
+    static void addStraights(uint64_t mask, MoveList& out);
+    static void addFlushes(uint64_t mask, MoveList& out);
+    static void addFullHouses(uint64_t mask, MoveList& out);
+    static void addFourOfAKinds(uint64_t mask, MoveList& out);
+
+public:
+    static void generate(CardSet hand, MoveList& out);                   //Every legal play
+    static void generateOfSize(CardSet hand, int cardCount, MoveList& out); //Plays that use cardCount cards
+};
+
+//Lists every legal play of the hand
+inline void MoveGenerator::generate(CardSet hand, MoveList& out)
+{
+    out.clear();
+    for (int cardCount = 1; cardCount <= 5; cardCount++)
+    {
+        addOfSize(hand.getMask(), cardCount, out);
+    }
+}
+//Lists the legal plays that use exactly cardCount cards
+inline void MoveGenerator::generateOfSize(CardSet hand, int cardCount, MoveList& out)
+{
+    out.clear();
+    addOfSize(hand.getMask(), cardCount, out);
+}
+inline void MoveGenerator::addOfSize(uint64_t mask, int cardCount, MoveList& out)
+{
+    switch (cardCount)
+    {
+        case 1: // Singles
+            for (uint64_t rest = mask; rest; rest &= rest - 1)
+            {
+                out.add(CardSet(rest & (~rest + 1)));
+            }
+            break;
+        case 2: // Pairs
+            addGroups(mask, 2, out);
+            break;
+        case 3: // Three of a Kind
+            addGroups(mask, 3, out);
+            break;
+        case 4: // Two Pair
+            addTwoPairs(mask, out);
+            break;
+        case 5: // Five card hands
+            addStraights(mask, out);
+            addFlushes(mask, out);
+            addFullHouses(mask, out);
+            addFourOfAKinds(mask, out);
+            break;
+        default:
+            break;
+    }
+}
+inline int MoveGenerator::findGroups(uint64_t mask, int cardsPerGroup, uint64_t* groups)
+{
+    int found = 0;
+    for (int rank = 1; rank <= 13; rank++)
+    {
+        uint64_t bits = rankBits(mask, rank);
+        if (popCount64(bits) < cardsPerGroup) continue;
+        for (uint64_t sub = bits; sub; sub = (sub - 1) & bits)
+        {
+            if (popCount64(sub) == cardsPerGroup) {
+                groups[found++] = sub << ((rank - 1) * 4);
+            }
+        }
+    }
+    return found;
+}
+inline void MoveGenerator::addGroups(uint64_t mask, int cardsPerGroup, MoveList& out)
+{
+    uint64_t groups[13 * 6];
+    int found = findGroups(mask, cardsPerGroup, groups);
+    for (int i = 0; i < found; i++)
+    {
+        out.add(CardSet(groups[i]));
+    }
+}
+inline void MoveGenerator::addTwoPairs(uint64_t mask, MoveList& out)
+{
+    uint64_t pairs[13 * 6];
+    int found = findGroups(mask, 2, pairs);
+    for (int i = 0; i < found; i++)
+    {
+        for (int j = i + 1; j < found; j++)
+        {
+            // Pairs of the same rank overlap or make four of a rank, which is not a two pair
+            if (lowestBit64(pairs[i]) / 4 != lowestBit64(pairs[j]) / 4) {
+                out.add(CardSet(pairs[i] | pairs[j]));
+            }
+        }
+    }
+}
+inline void MoveGenerator::addStraights(uint64_t mask, MoveList& out)
+{
+    //Straights run from 3-4-5-6-7 (ranks 1-5) up to J-Q-K-A-2 (ranks 9-13)
+    for (int low = 1; low <= 9; low++)
+    {
+        uint64_t bits[5];
+        bool present = true;
+        for (int i = 0; i < 5; i++)
+        {
+            bits[i] = rankBits(mask, low + i);
+            present = present && bits[i] != 0;
+        }
+        if (!present) continue;
+        //Pick one card of every rank
+        for (uint64_t a = bits[0]; a; a &= a - 1)
+        for (uint64_t b = bits[1]; b; b &= b - 1)
+        for (uint64_t c = bits[2]; c; c &= c - 1)
+        for (uint64_t d = bits[3]; d; d &= d - 1)
+        for (uint64_t e = bits[4]; e; e &= e - 1)
+        {
+            uint64_t move = (a & (~a + 1)) | ((b & (~b + 1)) << 4) | ((c & (~c + 1)) << 8) |
+                            ((d & (~d + 1)) << 12) | ((e & (~e + 1)) << 16);
+            out.add(CardSet(move << ((low - 1) * 4)));
+        }
+    }
+}
+inline void MoveGenerator::addFlushes(uint64_t mask, MoveList& out)
+{
+    for (int suit = 0; suit < 4; suit++)
+    {
+        uint64_t suited = mask & (CardSet::SUIT_MASK << suit);
+        int count = popCount64(suited);
+        if (count < 5) continue;
+
+        int position[13];
+        int n = 0;
+        for (uint64_t rest = suited; rest; rest &= rest - 1)
+        {
+            position[n++] = lowestBit64(rest);
+        }
+        //Walk every 5 card combination of the suit
+        int pick[5] = {0, 1, 2, 3, 4};
+        while (true)
+        {
+            uint64_t move = 0;
+            for (int i = 0; i < 5; i++)
+            {
+                move |= 1ULL << position[pick[i]];
+            }
+            // Consecutive ranks are straight flushes, already listed with the straights
+            int lowRank = position[pick[0]] / 4;
+            bool straight = position[pick[4]] / 4 == lowRank + 4;
+            if (!straight) {
+                out.add(CardSet(move));
+            }
+
+            int i = 4;
+            while (i >= 0 && pick[i] == n - 5 + i) i--;
+            if (i < 0) break;
+            pick[i]++;
+            for (int j = i + 1; j < 5; j++)
+            {
+                pick[j] = pick[j - 1] + 1;
+            }
+        }
+    }
+}
+inline void MoveGenerator::addFullHouses(uint64_t mask, MoveList& out)
+{
+    uint64_t triples[13 * 4];
+    uint64_t pairs[13 * 6];
+    int tripleCount = findGroups(mask, 3, triples);
+    if (tripleCount == 0) return;
+    int pairCount = findGroups(mask, 2, pairs);
+    for (int i = 0; i < tripleCount; i++)
+    {
+        for (int j = 0; j < pairCount; j++)
+        {
+            if (lowestBit64(triples[i]) / 4 != lowestBit64(pairs[j]) / 4) {
+                out.add(CardSet(triples[i] | pairs[j]));
+            }
+        }
+    }
+}
+inline void MoveGenerator::addFourOfAKinds(uint64_t mask, MoveList& out)
+{
+    for (int rank = 1; rank <= 13; rank++)
+    {
+        if (rankBits(mask, rank) != 0xF) continue;
+        uint64_t quad = 0xFULL << ((rank - 1) * 4);
+        for (uint64_t kickers = mask & ~quad; kickers; kickers &= kickers - 1)
+        {
+            out.add(CardSet(quad | (kickers & (~kickers + 1))));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+#include <cstdint>
+#include <string>
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PERF_COUNTERS_LINUX 1
+#else
+#define PERF_COUNTERS_LINUX 0
+#endif
+using namespace std;
+
+//Hardware counters the benchmarks read
+enum class PerfCounter
+{
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1dMisses,          //Level 1 data cache read misses
+    LlcMisses           //Last level cache read misses
+};
+const int PERF_COUNTERS = 5;
+
+//Counter totals of one or more measured stretches, a counter the system does not offer stays invalid
+struct PerfSample
+{
+    bool valid[PERF_COUNTERS] = {};
+    double values[PERF_COUNTERS] = {};
+};
+
+//Counts user space events of the calling thread through Linux perf_event_open.
+//Every counter is opened on its own, so a machine without (say) an LLC event
+//still gets the others; without any (no PMU in a virtual machine, a strict
+//perf_event_paranoid, not Linux) start and stop do nothing and why() says why.
+//When the kernel has to share the hardware between counters the totals are
+//scaled up by the share of the time each one was really counting.
+class PerfCounters
+{
+private:
+    int fds[PERF_COUNTERS];     //-1 when the counter could not be opened
+    string reason;              //Why the first counter that failed did
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    //True when at least one counter works
+    bool any() const;
+    const string& why() const { return reason; }
+    //Zeroes and starts every counter
+    void start();
+    //Stops every counter and adds what it counted since start to sample
+    void stop(PerfSample& sample);
+    static const char* name(PerfCounter counter);
+};
+
+inline const char* PerfCounters::name(PerfCounter counter)
+{
+    static const char* const NAMES[PERF_COUNTERS] = {"cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"};
+    return NAMES[static_cast<int>(counter)];
+}
+inline PerfCounters::PerfCounters()
+{
+    for (int i = 0; i < PERF_COUNTERS; i++) fds[i] = -1;
+#if PERF_COUNTERS_LINUX
+    const uint64_t cacheReadMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const uint32_t types[PERF_COUNTERS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                           PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE};
+    const uint64_t configs[PERF_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                             PERF_COUNT_HW_BRANCH_MISSES,
+                                             PERF_COUNT_HW_CACHE_L1D | cacheReadMiss,
+                                             PERF_COUNT_HW_CACHE_LL | cacheReadMiss};
+    for (int i = 0; i < PERF_COUNTERS; i++)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[i];
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fds[i] < 0 && reason.empty()) {
+            reason = string(name(static_cast<PerfCounter>(i))) + ": " + strerror(errno);
+        }
+    }
+#else
+    reason = "perf_event_open is Linux only";
+#endif
+}
+inline PerfCounters::~PerfCounters()
+{
+#if PERF_COUNTERS_LINUX
+    for (int fd : fds)
+    {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+inline bool PerfCounters::any() const
+{
+    for (int fd : fds)
+    {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+inline void PerfCounters::start()
+{
+#if PERF_COUNTERS_LINUX
+    for (int fd : fds)
+    {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+inline void PerfCounters::stop(PerfSample& sample)
+{
+#if PERF_COUNTERS_LINUX
+    for (int fd : fds)
+    {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < PERF_COUNTERS; i++)
+    {
+        // value, time enabled, time running
+        uint64_t data[3];
+        if (fds[i] < 0 || read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        // Never on the hardware in this stretch: nothing known, not zero
+        if (data[2] == 0) {
+            continue;
+        }
+        sample.valid[i] = true;
+        sample.values[i] += static_cast<double>(data[0]) * data[1] / data[2];
+    }
+#else
+    (void)sample;
+#endif
+}
+
+#endif
@@ -1,11 +1,17 @@
 #ifndef PLAYER_H
 #define PLAYER_H
+#include "BatchEvaluator.h"
 #include "Deck.h"
 #include "PlayingHand.h"
+#include "MoveGenerator.h"
+#include "IsMcts.h"
+#include "EndgameSolver.h"
+#include "Latency.h"
+#include "Trace.h"
+#include <memory>
 #include <string>
 #include <sstream>
 #include <iostream>
-#include <map>
 #include <set>
 
 // AI Behavior Configuration
@@ -13,61 +19,44 @@ const int AGGRESSIVE_CARD_COUNT = 3;     // Be aggressive when cards <= this
 const int VERY_STRONG_HAND_TYPE = 8;     // Four of a kind and above
 const int MODERATE_HAND_TYPE = 5;        // Straight and above
 
+// How an AI seat picks its plays
+enum class AiMode
+{
+    Heuristic,      // The rules of aiTurn below
+    Mcts            // Information set Monte Carlo tree search (IsMcts.h), needs a TableView
+};
+
 class Player
 {
+    friend class PlayerBenchmark;   //Lets bench.cpp time the private AI steps
 private:
-    map<int,string> handType =
-    {
-        {0, "Skip"},
-        {1,"High Card"},
-        {2, "Pair"},
-        {3, "Two Pair"},
-        {4, "Three Of A Kind"},
-        {5, "Straight"},
-        {6, "Flush"}, 
-        {7, "Full House"},
-        {8, "Four Of A Kind"},
-        {9, "Straight Flush"},
-        {10,"Royal Flush"}
-    };
-    map<int, string> cardRankRef = { 
-        {1, "3"},
-        {2, "4"},
-        {3, "5"},
-        {4, "6"},
-        {5, "7"},
-        {6, "8"},
-        {7, "9"},
-        {8, "10"},
-        {9, "J"},
-        {10, "Q"},
-        {11, "K"},
-        {12, "A"},
-        {13, "2"}}; //Map for card rank
-    map<int, char> cardSuitesRef = 
-    {{1, '&'},
-    {2, '^'},
-    {3, 'V'},
-    {4, 'O'}};  //Map for suit rank
-
     string playerName;
     bool isAi;
+    bool isQuiet = false;   //Skips every console message of the AI turn (used by simulations)
     Deck playerDeck;
     PlayingHand playerHand;
+    AiMode aiMode = AiMode::Heuristic;
+    shared_ptr<IsMctsSearch> mcts;      //Search of the Mcts mode (copies of the player share it)
+    shared_ptr<EndgameSolver> endgame;  //Takes over the last few cards when set (may be shared by a table)
+    Philox4x32 aiStream;                //Seeds of the searches, one number per search
 
     list<int> handSelection();
-    PlayingHand findBestHand(PlayingHand hand);
-    bool shouldPass(PlayingHand currentHand);
-    PlayingHand tryHandCombination(const std::list<Card>& cards, 
-                                 std::list<Card>::const_iterator start,
-                                 size_t count,
+    PlayingHand findBestHand(CardSet cards);
+    bool shouldPass(const PlayingHand& currentHand);
+    PlayingHand tryHandCombination(CardSet cards,
                                  int requiredType,
-                                 PlayingHand currentHand);
-    bool isValidPlay(PlayingHand selectedHand, PlayingHand currentHand);
+                                 const PlayingHand& currentHand);
+    bool isValidPlay(const PlayingHand& selectedHand, const PlayingHand& currentHand);
+    void announceHand(const PlayingHand& hand);
+    void mctsTurn(const PlayingHand& currentHand, const TableView& table);
+    bool endgameTurn(const PlayingHand& currentHand, const TableView& table);
+    void playMove(CardSet move);
+    uint64_t nextAiSeed();
 
 public:
     void addToPlayerHand(list<Card>);
     void addToPlayerHand(Card);
+    void addToPlayerHand(CardSet);          //Adds a dealt hand (lowest card first)
     //---Instantiation Routines---
     Player();
     Player(bool);
@@ -81,12 +70,26 @@ public:
     bool operator>=(const Player&) const;
 
     //---Turn Routines---
-    void playerTurn(PlayingHand);
-    void aiTurn(PlayingHand);
+    void playerTurn(const PlayingHand&);
+    void aiTurn(const PlayingHand&);   //Does not touch the heap (see bench.cpp allocs_per_op)
     //---Player Object Decision---
-    PlayingHand decision(PlayingHand);
+    PlayingHand decision(const PlayingHand&);
+    PlayingHand decision(const PlayingHand&, const TableView&);   //Lets the Mcts mode see the table
+    //---Picks the AI of this seat and seeds its search
+    void setAiMode(AiMode, const MctsConfig& config = MctsConfig());
+    AiMode getAiMode() const { return aiMode; }
+    void seedAi(uint64_t seed, uint64_t stream);    //Searches draw from stream of seed (see Random.h)
+    //The rule of shouldPass on plain numbers (used by big2_replay on recorded games)
+    static bool passRule(int cardsHeld, int typeToBeat);
+    const IsMctsSearch* getMctsSearch() const { return mcts.get(); }
+    //---Hands the last cards of a game to an exact solver (nullptr turns it off)
+    void setEndgameSolver(shared_ptr<EndgameSolver>);
     //---Get amount of cards the player has
     int getAmountOfCards();
+    //---Turns the AI console messages off (or back on)
+    void setQuiet(bool);
+    //---Throws away every card so the player can be dealt a new game
+    void clearCards();
     const Deck& getPlayerDeck() const { return playerDeck; }
 };
 Player::Player()
@@ -113,6 +116,10 @@ void Player::addToPlayerHand(Card C)
 {
     playerDeck.placeCardIntoDeck(C);
 }
+void Player::addToPlayerHand(CardSet Cs)
+{
+    playerDeck.placeCardsIntoDeck(Cs);
+}
 bool Player::operator==(const Player& other) const {
     return playerHand == other.playerHand;
 }
@@ -136,16 +143,15 @@ bool Player::operator<=(const Player& other) const {
 bool Player::operator>=(const Player& other) const {
     return !(*this < other);
 }
-void Player::playerTurn(PlayingHand currentHand) {
+void Player::playerTurn(const PlayingHand& currentHand) {
     cout << "===---[[Your Turn]]---===" << endl;
     char selection;
     bool validPlay = false;
 
     do {
         // Display current hand if there is one
-        if (!currentHand.getCards().empty()) {
+        if (!currentHand.empty()) {
             cout << "=-=LAST PLAYED HAND=-=" << endl;
-            currentHand.evaluateHand();
             currentHand.displayHand();
         } else {
             cout << "You can play any valid hand combination!" << endl;
@@ -169,7 +175,7 @@ void Player::playerTurn(PlayingHand currentHand) {
 
         if (!validPlay) {
             cout << "Invalid play! ";
-            if (currentHand.getCards().empty()) {
+            if (currentHand.empty()) {
                 cout << "Must be a valid hand combination." << endl;
             } else {
                 cout << "Must match hand type and beat the current hand." << endl;
@@ -181,9 +187,9 @@ void Player::playerTurn(PlayingHand currentHand) {
 
         // Display the hand being played
         cout << "===HAND BEING PLAYED===" << endl;
-        cout << "HAND: " << handType[playerHand.getHandType()] << endl;
-        cout << "RANK: " << cardRankRef[playerHand.getHighestCardRank()] << endl;
-        cout << "SUIT: " << cardSuitesRef[playerHand.getHighestHandSuit()] << endl;
+        cout << "HAND: " << PlayingHand::handTypeName(playerHand.getHandType()) << endl;
+        cout << "RANK: " << Card::rankName(playerHand.getHighestCardRank()) << endl;
+        cout << "SUIT: " << Card::suitName(playerHand.getHighestHandSuit()) << endl;
 
         cout << "Type o to confirm, type anything else to reselect: ";
         cin >> selection;
@@ -240,44 +246,39 @@ list<int> Player::handSelection()
      list<int> output(cleanedInput.begin(), cleanedInput.end());
      return output;
 }
-void Player::aiTurn(PlayingHand currentHand) {
-    cout << "===---[[AI Turn]]---===" << endl;
-    
-    // Convert player's deck to a PlayingHand for AI evaluation
-    PlayingHand aiHand;
-    for (const auto& card : playerDeck.getCards()) {
-        aiHand.addToHand(card);
+void Player::aiTurn(const PlayingHand& currentHand) {
+    LATENCY_SCOPE(LatencyProbe::AiTurn);
+    TRACE_SCOPE("aiTurn");
+    if (!isQuiet) {
+        cout << "===---[[AI Turn]]---===" << endl;
     }
     
     // If no hand is being played (after all players passed), find the best possible hand
-    if (currentHand.getCards().empty()) {
-        PlayingHand bestHand = findBestHand(aiHand);
+    if (currentHand.empty()) {
+        PlayingHand bestHand = findBestHand(playerDeck.getCardSet());
         // Remove the cards from the deck that were used in the hand
-        for (const auto& card : bestHand.getCards()) {
-            playerDeck.removeCard(card);
-        }
+        playerDeck.removeCards(bestHand.getCardSet());
         playerHand = bestHand;
-        cout << "===HAND BEING PLAYED===" << endl;
-        cout << "HAND: " << handType[bestHand.getHandType()] << endl;
-        cout << "RANK: " << cardRankRef[bestHand.getHighestCardRank()] << endl;
-        cout << "SUIT: " << cardSuitesRef[bestHand.getHighestHandSuit()] << endl;
+        announceHand(bestHand);
         return;
     }
 
     // Get the required hand type and card count
     int requiredType = currentHand.getHandType();
-    int requiredCount = currentHand.getCards().size();
+    int requiredCount = currentHand.size();
     
     // Try to find a valid hand to play that matches the current hand type
-    std::list<Card> allCards = playerDeck.getCards();
+    TRACE_PHASE(phase, "generate");
+    MoveList candidates;
+    MoveGenerator::generateOfSize(playerDeck.getCardSet(), requiredCount, candidates);
     PlayingHand bestHand;
     int bestRank = -1;
 
-    // Try each possible starting position
-    for (auto start = allCards.begin(); start != allCards.end(); ++start) {
-        PlayingHand tempHand = tryHandCombination(allCards, start, requiredCount, 
-                                                requiredType, currentHand);
-        if (!tempHand.getCards().empty() && 
+    // Try each legal play that uses the same amount of cards
+    TRACE_NEXT(phase, "filter");
+    for (const auto& candidate : candidates) {
+        PlayingHand tempHand = tryHandCombination(candidate, requiredType, currentHand);
+        if (!tempHand.empty() && 
             tempHand.getHighestCardRank() > bestRank) {
             bestHand = tempHand;
             bestRank = tempHand.getHighestCardRank();
@@ -285,170 +286,123 @@ void Player::aiTurn(PlayingHand currentHand) {
     }
 
     // If we found a valid hand to play
+    TRACE_NEXT(phase, "choose");
     if (bestRank > -1) {
         // Remove the cards from the deck that were used in the hand
-        for (const auto& card : bestHand.getCards()) {
-            playerDeck.removeCard(card);
-        }
+        playerDeck.removeCards(bestHand.getCardSet());
         playerHand = bestHand;
-        cout << "===HAND BEING PLAYED===" << endl;
-        cout << "HAND: " << handType[bestHand.getHandType()] << endl;
-        cout << "RANK: " << cardRankRef[bestHand.getHighestCardRank()] << endl;
-        cout << "SUIT: " << cardSuitesRef[bestHand.getHighestHandSuit()] << endl;
+        announceHand(bestHand);
         return;
     }
 
     // Check if we should pass
     if (shouldPass(currentHand)) {
-        cout << "AI passes" << endl;
+        if (!isQuiet) {
+            cout << "AI passes" << endl;
+        }
         return;
     }
 
     // Try aggressive play if we have few cards
-    if (playerDeck.getCards().size() <= AGGRESSIVE_CARD_COUNT) {
-        PlayingHand aggressiveHand = findBestHand(aiHand);
-        if (aggressiveHand.getHandType() == requiredType && 
-            aggressiveHand.getCards().size() == requiredCount &&
-            aggressiveHand.getHighestCardRank() > currentHand.getHighestCardRank()) {
+    if (playerDeck.size() <= AGGRESSIVE_CARD_COUNT) {
+        PlayingHand aggressiveHand = findBestHand(playerDeck.getCardSet());
+        if (HandEvaluator::beats(aggressiveHand.getOrderKey(), currentHand.getOrderKey())) {
             // Remove the cards from the deck that were used in the hand
-            for (const auto& card : aggressiveHand.getCards()) {
-                playerDeck.removeCard(card);
-            }
+            playerDeck.removeCards(aggressiveHand.getCardSet());
             playerHand = aggressiveHand;
-            cout << "===HAND BEING PLAYED===" << endl;
-            cout << "HAND: " << handType[aggressiveHand.getHandType()] << endl;
-            cout << "RANK: " << cardRankRef[aggressiveHand.getHighestCardRank()] << endl;
-            cout << "SUIT: " << cardSuitesRef[aggressiveHand.getHighestHandSuit()] << endl;
+            announceHand(aggressiveHand);
             return;
         }
     }
 
-    cout << "AI passes" << endl;
+    if (!isQuiet) {
+        cout << "AI passes" << endl;
+    }
 }
 
-PlayingHand Player::findBestHand(PlayingHand hand) {
-    std::list<Card> allCards = hand.getCards();
-    PlayingHand bestHand;
-    int bestHandType = -1;
-    int bestCardRank = -1;
-
-    // When starting a new round (no current hand), try to find the most efficient hand
-    // that will help reduce the number of cards quickly
-    if (hand.getCards().empty()) {
-        // First try to find hands that use more cards
-        for (int targetType = 8; targetType >= 1; --targetType) {  // Start with four of a kind
-            for (size_t i = 1; i <= allCards.size(); ++i) {
-                std::vector<bool> mask(allCards.size(), false);
-                std::fill(mask.begin(), mask.begin() + i, true);
-                
-                do {
-                    PlayingHand tempHand;
-                    auto it = allCards.begin();
-                    for (size_t j = 0; j < allCards.size(); ++j) {
-                        if (mask[j]) {
-                            tempHand.addToHand(*it);
-                        }
-                        ++it;
-                    }
-                    
-                    tempHand.evaluateHand();
-                    if (tempHand.getHandType() == targetType) {
-                        // Prefer hands that use more cards
-                        if (tempHand.getCards().size() > bestHand.getCards().size() ||
-                            (tempHand.getCards().size() == bestHand.getCards().size() &&
-                             tempHand.getHighestCardRank() > bestCardRank)) {
-                            bestHandType = tempHand.getHandType();
-                            bestCardRank = tempHand.getHighestCardRank();
-                            bestHand = tempHand;
-                        }
-                    }
-                } while (std::prev_permutation(mask.begin(), mask.end()));
-            }
-        }
-        return bestHand;
+//Shows the hand the AI is about to play
+void Player::announceHand(const PlayingHand& hand) {
+    if (isQuiet) {
+        return;
     }
+    TRACE_SCOPE("render");
+    cout << "===HAND BEING PLAYED===" << endl;
+    cout << "HAND: " << PlayingHand::handTypeName(hand.getHandType()) << endl;
+    cout << "RANK: " << Card::rankName(hand.getHighestCardRank()) << endl;
+    cout << "SUIT: " << Card::suitName(hand.getHighestHandSuit()) << endl;
+}
 
-    // When trying to beat a current hand, find the highest possible hand type
-    for (int targetType = 10; targetType >= 1; --targetType) {
-        for (size_t i = 1; i <= allCards.size(); ++i) {
-            std::vector<bool> mask(allCards.size(), false);
-            std::fill(mask.begin(), mask.begin() + i, true);
-            
-            do {
-                PlayingHand tempHand;
-                auto it = allCards.begin();
-                for (size_t j = 0; j < allCards.size(); ++j) {
-                    if (mask[j]) {
-                        tempHand.addToHand(*it);
-                    }
-                    ++it;
-                }
-                
-                tempHand.evaluateHand();
-                if (tempHand.getHandType() == targetType) {
-                    if (tempHand.getHandType() > bestHandType || 
-                        (tempHand.getHandType() == bestHandType && 
-                         tempHand.getHighestCardRank() > bestCardRank)) {
-                        bestHandType = tempHand.getHandType();
-                        bestCardRank = tempHand.getHighestCardRank();
-                        bestHand = tempHand;
-                    }
-                }
-            } while (std::prev_permutation(mask.begin(), mask.end()));
-        }
-        
-        if (bestHandType == targetType) {
-            return bestHand;
+PlayingHand Player::findBestHand(CardSet cards) {
+    LATENCY_SCOPE(LatencyProbe::FindBestHand);
+    TRACE_SCOPE("findBestHand");
+    // List every legal play of the cards and keep the strongest one:
+    // highest hand type first, then highest card rank, then highest suit
+    // (the order of the order keys, the first of equal plays is kept)
+    TRACE_PHASE(phase, "generate");
+    MoveList moves;
+    MoveGenerator::generate(cards, moves);
+
+    TRACE_NEXT(phase, "filter");
+    uint32_t keys[MoveList::MAX_MOVES];
+    BatchEvaluator::orderKeys(moves.data(), moves.size(), keys);
+
+    TRACE_NEXT(phase, "choose");
+    CardSet bestCards;
+    uint32_t bestKey = 0;
+    for (int i = 0; i < moves.size(); i++) {
+        if (keys[i] > bestKey) {
+            bestKey = keys[i];
+            bestCards = moves[i];
         }
     }
-    
+
+    PlayingHand bestHand(bestCards);
+    bestHand.evaluateHand();
     return bestHand;
 }
 
-bool Player::shouldPass(PlayingHand currentHand) {
+bool Player::shouldPass(const PlayingHand& currentHand) {
+    return passRule(playerDeck.size(), currentHand.getHandType());
+}
+
+bool Player::passRule(int cardsHeld, int typeToBeat) {
     // Don't pass if we have very few cards
-    if (playerDeck.getCards().size() <= AGGRESSIVE_CARD_COUNT) {
+    if (cardsHeld <= AGGRESSIVE_CARD_COUNT) {
         return false;
     }
 
     // Pass if current hand is very strong
-    if (currentHand.getHandType() >= VERY_STRONG_HAND_TYPE) {
+    if (typeToBeat >= VERY_STRONG_HAND_TYPE) {
         return true;
     }
 
     // Pass if we have many cards and current hand is moderate
-    if (playerDeck.getCards().size() > 5 && 
-        currentHand.getHandType() >= MODERATE_HAND_TYPE) {
+    if (cardsHeld > 5 && 
+        typeToBeat >= MODERATE_HAND_TYPE) {
         return true;
     }
 
     return false;
 }
 
-PlayingHand Player::tryHandCombination(const std::list<Card>& cards, 
-                                     std::list<Card>::const_iterator start,
-                                     size_t count,
+PlayingHand Player::tryHandCombination(CardSet cards,
                                      int requiredType,
-                                     PlayingHand currentHand) {
-    PlayingHand tempHand;
-    auto it = start;
-    for (size_t i = 0; i < count; ++i) {
-        tempHand.addToHand(*it);
-        ++it;
-    }
-    
-    tempHand.evaluateHand();
+                                     const PlayingHand& currentHand) {
+    // Classify the candidate before building a hand out of it
+    uint32_t key = HandEvaluator::orderKey(cards);
     
-    if (tempHand.getHandType() == requiredType && 
-        tempHand.getHighestCardRank() > currentHand.getHighestCardRank()) {
+    if (HandEvaluator::typeOf(key) == requiredType &&
+        HandEvaluator::beats(key, currentHand.getOrderKey())) {
+        PlayingHand tempHand(cards);
+        tempHand.evaluateHand();
         return tempHand;
     }
     return PlayingHand();
 }
 
-bool Player::isValidPlay(PlayingHand selectedHand, PlayingHand currentHand) {
+bool Player::isValidPlay(const PlayingHand& selectedHand, const PlayingHand& currentHand) {
     // If no hand is being played, validate the hand type and card count
-    if (currentHand.getCards().empty()) {
+    if (currentHand.empty()) {
         // Must be a valid hand type
         if (selectedHand.getHandType() <= 0) {
             return false;
@@ -457,61 +411,140 @@ bool Player::isValidPlay(PlayingHand selectedHand, PlayingHand currentHand) {
         // Validate card count based on hand type
         switch (selectedHand.getHandType()) {
             case 1: // High Card
-                return selectedHand.getCards().size() == 1;
+                return selectedHand.size() == 1;
             case 2: // Pair
-                return selectedHand.getCards().size() == 2;
+                return selectedHand.size() == 2;
             case 3: // Two Pair
-                return selectedHand.getCards().size() == 4;
+                return selectedHand.size() == 4;
             case 4: // Three of a Kind
-                return selectedHand.getCards().size() == 3;
+                return selectedHand.size() == 3;
             case 5: // Straight
             case 6: // Flush
             case 7: // Full House
             case 8: // Four of a Kind
             case 9: // Straight Flush
             case 10: // Royal Flush
-                return selectedHand.getCards().size() == 5;
+                return selectedHand.size() == 5;
             default:
                 return false;
         }
     }
 
-    // Must match the hand type and card count
-    if (selectedHand.getHandType() != currentHand.getHandType() ||
-        selectedHand.getCards().size() != currentHand.getCards().size()) {
-        return false;
-    }
-
-    // Must have a higher card rank
-    return selectedHand.getHighestCardRank() > currentHand.getHighestCardRank();
+    // Must match the hand type and card count and have a higher card rank
+    return HandEvaluator::beats(selectedHand.getOrderKey(), currentHand.getOrderKey());
 }
 
-PlayingHand Player::decision(PlayingHand currentHand)
+PlayingHand Player::decision(const PlayingHand& currentHand)
+{
+    TableView noTable;
+    noTable.seat = -1;
+    return decision(currentHand, noTable);
+}
+PlayingHand Player::decision(const PlayingHand& currentHand, const TableView& table)
 {
-    if (!currentHand.getCards().empty()) {
+    LATENCY_SCOPE(LatencyProbe::Decision);
+    TRACE_SCOPE("decision");
+    if (!currentHand.empty() && !isQuiet) {
+        TRACE_SCOPE("render");
         cout << "=-=LAST PLAYED HAND=-=" << endl;
-        currentHand.evaluateHand();  // Evaluate the hand first
-        cout << "HAND: " << handType[currentHand.getHandType()] << endl;
-        cout << "RANK: " << cardRankRef[currentHand.getHighestCardRank()] << endl;
-        cout << "SUIT: " << cardSuitesRef[currentHand.getHighestHandSuit()] << endl;
+        cout << "HAND: " << PlayingHand::handTypeName(currentHand.getHandType()) << endl;
+        cout << "RANK: " << Card::rankName(currentHand.getHighestCardRank()) << endl;
+        cout << "SUIT: " << Card::suitName(currentHand.getHighestHandSuit()) << endl;
         cout << "Cards: " << endl;
         currentHand.displayHand();
     }
 
-    PlayingHand temp;
     if(isAi == true)
     {
-        aiTurn(currentHand);
-        return playerHand.discardHand();
+        if (table.seat >= 0 && endgameTurn(currentHand, table)) {
+            // The solver found a winning line
+        } else if (aiMode == AiMode::Mcts && table.seat >= 0) {
+            mctsTurn(currentHand, table);
+        } else {
+            aiTurn(currentHand);
+        }
     }
     else
     {
         playerTurn(currentHand);
-        return playerHand.discardHand();
     }
+    // Hand the played cards over without going through a list
+    PlayingHand played = playerHand;
+    playerHand = PlayingHand();
+    return played;
+}
+//Lets the tree search pick the play (see IsMcts.h)
+void Player::mctsTurn(const PlayingHand& currentHand, const TableView& table)
+{
+    TRACE_SCOPE("mcts");
+    if (!isQuiet) {
+        cout << "===---[[AI Turn]]---===" << endl;
+    }
+    playMove(mcts->chooseMove(playerDeck.getCardSet(), currentHand.getCardSet(), table, nextAiSeed()));
+}
+//Lets the exact solver move once few cards are left, false when it has no winning line
+bool Player::endgameTurn(const PlayingHand& currentHand, const TableView& table)
+{
+    if (!endgame || !endgame->appliesTo(table)) {
+        return false;
+    }
+    TRACE_SCOPE("endgame");
+    CardSet move;
+    if (!endgame->chooseMove(playerDeck.getCardSet(), currentHand.getCardSet(), table, nextAiSeed(), move)) {
+        return false;
+    }
+    if (!isQuiet) {
+        cout << "===---[[AI Turn]]---===" << endl;
+    }
+    playMove(move);
+    return true;
+}
+//Plays the cards of a search (an empty move passes)
+void Player::playMove(CardSet move)
+{
+    if (move.empty()) {
+        if (!isQuiet) {
+            cout << "AI passes" << endl;
+        }
+        return;
+    }
+    playerDeck.removeCards(move);
+    playerHand = PlayingHand(move);
+    announceHand(playerHand);
+}
+//Seed of the next search, so every search of a seeded game draws different deals
+uint64_t Player::nextAiSeed()
+{
+    return aiStream();
+}
+void Player::setAiMode(AiMode mode, const MctsConfig& config)
+{
+    aiMode = mode;
+    if (mode == AiMode::Mcts) {
+        mcts = make_shared<IsMctsSearch>(config);
+    } else {
+        mcts.reset();
+    }
+}
+void Player::seedAi(uint64_t seed, uint64_t stream)
+{
+    aiStream = Philox4x32(seed, stream);
+}
+void Player::setEndgameSolver(shared_ptr<EndgameSolver> solver)
+{
+    endgame = solver;
 }
   int Player::getAmountOfCards()
   {
     return playerDeck.size() + playerHand.size();
   }
+  void Player::setQuiet(bool b)
+  {
+    isQuiet = b;
+  }
+  void Player::clearCards()
+  {
+    playerDeck.removeCards(playerDeck.getCardSet());
+    playerHand.discardHand();
+  }
 #endif
\ No newline at end of file
@@ -1,63 +1,40 @@
 #ifndef PLAYINGHAND_H
 #define PLAYINGHAND_H
 #include "Card.h"
+#include "CardSet.h"
+#include "HandEvaluator.h"
+#include "Latency.h"
 #include <list>
-#include <unordered_map>
-#include <map>
+#include <algorithm>
 using namespace std;
 class PlayingHand
 {
+    friend class PlayingHandBenchmark;  //Lets bench.cpp time getHandCards
 private:
-map<int, string> cardRankRef = { 
-    {1, "3"},
-    {2, "4"},
-    {3, "5"},
-    {4, "6"},
-    {5, "7"},
-    {6, "8"},
-    {7, "9"},
-    {8, "10"},
-    {9, "J"},
-    {10, "Q"},
-    {11, "K"},
-    {12, "A"},
-    {13, "2"}}; //Map for card rank
-    map<int, char> cardSuitesRef = 
-    {{1, '&'},
-    {2, '^'},
-    {3, 'V'},
-    {4, 'O'}};  //Map for suit rank
-list<Card> Cards;                       //Stores the actual cards that are played
-list<int> Sequence;                     //Stores the rank sequence of the cardss 
-unordered_map<int,int> CardRankAmount;  //Indicates how much a rank shoes up in a given hand
-unordered_map<int,int> CardSuitAmount;  //Indicates how much a suit shoes up in a given hand
+static constexpr int MAX_CARDS = 13;    //A player never holds more than a full deal
+Card Cards[MAX_CARDS];                  //Stores the actual cards that are played (the first Count slots)
+int Count = 0;                          //Slots of Cards in use
+CardSet Members;                        //Bit set mirror of Cards for constant time lookups
+uint8_t rankCount[13] = {};             //Cards held of every rank (rank - 1), kept up to date as cards come and go
+uint8_t suitCount[4] = {};              //Cards held of every suit (suit - 1)
 
-int handType;           //Indicates the hand type singles, royal flush      (0-10)
-int highestCardRank;    //Indicates the highest card rank (when applicable) (1-13)
-int highestHandSuit;    //Indicates the highest hand suit (when applicable) (1-4)
+//Evaluation cache, filled in on first use after the cards change
+mutable bool isEvaluated = false;   //False while the values below are out of date
+mutable int handType = -1;           //Indicates the hand type singles, royal flush      (0-10)
+mutable int highestCardRank = -1;    //Indicates the highest card rank (when applicable) (1-13)
+mutable int highestHandSuit = -1;    //Indicates the highest hand suit (when applicable) (1-4)
+mutable uint32_t orderKey = 0;       //HandEvaluator::orderKey of the cards
 
-//---HELPER FUNCTIONS---
-bool isHighCard();      //Determines if the hand is a high card
-bool isPair();          //Detemines if the hand is a pair
-bool isTwoPair();       //Detemines if the hand is a two pair
-bool isThreeOfAKind();  //Detemines if the hand is three of a kind
-bool isStraight();      //Determines if the hand is a straight
-bool isFlush();         //Detemines if the hand is a flush
-bool isFullHouse();     //Determines if the hand is a fullhouse
-bool isFourOfAKind();   //Determines if the hand is a four of kind
-bool isStraightFlush(); //Determines if the hand if a straight flush
-bool isRoyalFlush();    //Determines if the hand is a royal flush
-
-int evaluateHandType();            //Evaluates the hand type
-int evalHighestCardRank();         //Evaluates the highest card rank in the hand
-int evalHighestCardSuit();         //Evaluates the highest card suit
-void clearPriorEval();             //Clears prior data before evaulating again
+void refreshEvaluation() const;     //Evaluates the cards if the cache is out of date
+void eraseAt(int);                  //Closes the gap left by the card in slot I
+void countCard(const Card& C, int delta) {
+    rankCount[C.getCard() - 1] += delta;
+    suitCount[C.getSuit() - 1] += delta;
+}
 
 // Helper function to get cards that make up the hand type
 list<Card> getHandCards() const {
-    // Create a copy of this hand to evaluate
-    PlayingHand temp = *this;
-    temp.evaluateHand();
+    refreshEvaluation();
     
     list<Card> handCards;
     list<int> sortedRanks;  // Moved outside switch
@@ -67,23 +44,17 @@ list<Card> getHandCards() const {
     int pairRank = -1;  // Moved outside switch
     int fourRank = -1;  // Moved outside switch
     
-    switch (temp.handType) {
+    switch (handType) {
         case 1: // High Card
             // Return the highest card
-            return {*max_element(Cards.begin(), Cards.end(), 
+            return {*max_element(begin(), end(), 
                 [](const Card& a, const Card& b) { return a.getCard() < b.getCard(); })};
 
         case 2: // Pair
             // Return the pair
-            for (const auto& card : Cards) {
-                int count = 0;
-                for (const auto& other : Cards) {
-                    if (card.getCard() == other.getCard()) {
-                        count++;
-                    }
-                }
-                if (count == 2) {
-                    for (const auto& other : Cards) {
+            for (const auto& card : *this) {
+                if (rankCount[card.getCard() - 1] == 2) {
+                    for (const auto& other : *this) {
                         if (other.getCard() == card.getCard()) {
                             handCards.push_back(other);
                         }
@@ -95,19 +66,13 @@ list<Card> getHandCards() const {
 
         case 3: // Two Pair
             // Return both pairs
-            for (const auto& card : Cards) {
-                int count = 0;
-                for (const auto& other : Cards) {
-                    if (card.getCard() == other.getCard()) {
-                        count++;
-                    }
-                }
-                if (count == 2 && find(pairRanks.begin(), pairRanks.end(), card.getCard()) == pairRanks.end()) {
+            for (const auto& card : *this) {
+                if (rankCount[card.getCard() - 1] == 2 && find(pairRanks.begin(), pairRanks.end(), card.getCard()) == pairRanks.end()) {
                     pairRanks.push_back(card.getCard());
                 }
             }
             for (int rank : pairRanks) {
-                for (const auto& card : Cards) {
+                for (const auto& card : *this) {
                     if (card.getCard() == rank) {
                         handCards.push_back(card);
                     }
@@ -117,15 +82,9 @@ list<Card> getHandCards() const {
 
         case 4: // Three of a Kind
             // Return the three cards
-            for (const auto& card : Cards) {
-                int count = 0;
-                for (const auto& other : Cards) {
-                    if (card.getCard() == other.getCard()) {
-                        count++;
-                    }
-                }
-                if (count == 3) {
-                    for (const auto& other : Cards) {
+            for (const auto& card : *this) {
+                if (rankCount[card.getCard() - 1] == 3) {
+                    for (const auto& other : *this) {
                         if (other.getCard() == card.getCard()) {
                             handCards.push_back(other);
                         }
@@ -139,14 +98,14 @@ list<Card> getHandCards() const {
         case 9: // Straight Flush
         case 10: // Royal Flush
             // Return the 5 cards in sequence
-            for (const auto& card : Cards) {
+            for (const auto& card : *this) {
                 sortedRanks.push_back(card.getCard());
             }
             sortedRanks.sort();
             sortedRanks.unique();
             it = sortedRanks.begin();
             for (int i = 0; i < 5; ++i) {
-                for (const auto& card : Cards) {
+                for (const auto& card : *this) {
                     if (card.getCard() == *it) {
                         handCards.push_back(card);
                         break;
@@ -159,8 +118,11 @@ list<Card> getHandCards() const {
         case 6: // Flush
             // Return the 5 highest cards of the same suit
             for (int suit = 1; suit <= 4; ++suit) {
+                if (suitCount[suit - 1] < 5) {
+                    continue;
+                }
                 list<Card> suitedCards;
-                for (const auto& card : Cards) {
+                for (const auto& card : *this) {
                     if (card.getSuit() == suit) {
                         suitedCards.push_back(card);
                     }
@@ -181,37 +143,23 @@ list<Card> getHandCards() const {
 
         case 7: // Full House
             // Find three of a kind
-            for (const auto& card : Cards) {
-                int count = 0;
-                for (const auto& other : Cards) {
-                    if (card.getCard() == other.getCard()) {
-                        count++;
-                    }
-                }
-                if (count == 3) {
+            for (const auto& card : *this) {
+                if (rankCount[card.getCard() - 1] == 3) {
                     threeRank = card.getCard();
                     break;
                 }
             }
             
             // Find pair
-            for (const auto& card : Cards) {
-                if (card.getCard() != threeRank) {
-                    int count = 0;
-                    for (const auto& other : Cards) {
-                        if (card.getCard() == other.getCard()) {
-                            count++;
-                        }
-                    }
-                    if (count == 2) {
-                        pairRank = card.getCard();
-                        break;
-                    }
+            for (const auto& card : *this) {
+                if (card.getCard() != threeRank && rankCount[card.getCard() - 1] == 2) {
+                    pairRank = card.getCard();
+                    break;
                 }
             }
             
             // Add the cards
-            for (const auto& card : Cards) {
+            for (const auto& card : *this) {
                 if (card.getCard() == threeRank || card.getCard() == pairRank) {
                     handCards.push_back(card);
                 }
@@ -220,28 +168,22 @@ list<Card> getHandCards() const {
 
         case 8: // Four of a Kind
             // Find four of a kind
-            for (const auto& card : Cards) {
-                int count = 0;
-                for (const auto& other : Cards) {
-                    if (card.getCard() == other.getCard()) {
-                        count++;
-                    }
-                }
-                if (count == 4) {
+            for (const auto& card : *this) {
+                if (rankCount[card.getCard() - 1] == 4) {
                     fourRank = card.getCard();
                     break;
                 }
             }
             
             // Add the four cards
-            for (const auto& card : Cards) {
+            for (const auto& card : *this) {
                 if (card.getCard() == fourRank) {
                     handCards.push_back(card);
                 }
             }
             
             // Add highest remaining card as kicker
-            for (const auto& card : Cards) {
+            for (const auto& card : *this) {
                 if (card.getCard() != fourRank) {
                     handCards.push_back(card);
                     break;
@@ -255,17 +197,19 @@ list<Card> getHandCards() const {
 public:
 PlayingHand();          //Instantiates the playinghand object
 PlayingHand(list<Card>);//Instantiates hand with a set of cards
+PlayingHand(CardSet);   //Instantiates hand with the cards of a bit set (lowest card first)
 ~PlayingHand();         //Destroys the intance of the playing hand object
-int getHandType();
-int getHighestCardRank();
-int getHighestHandSuit();
+int getHandType() const;
+static const char* handTypeName(int);   //Name of a hand type (0 = Skip)
+int getHighestCardRank() const;
+int getHighestHandSuit() const;
+uint32_t getOrderKey() const;           //One integer that orders and compares plays (see HandEvaluator.h)
 //---SPECIAL FUNCTIONS---
 void addToHand(Card);                       //Adds a card to the hand that is playing
 void addToHand(list<Card>);                 //Adds a set of cards into hand
 Card removeCardFromPlay(int);               //Returns the card to another object of the selected index 
 list<Card> removeCardsFromPlay(list<int>);  //Returns a list of chosen cards from the hand
 list<Card> discardHand();
-void evaluateData();
 void evaluateHand();
 void displayHand() const;
 //---OPERATOR OVERLOADS---
@@ -277,7 +221,12 @@ bool operator<=(const PlayingHand&) const;
 bool operator>=(const PlayingHand&) const;
 
 list<Card> getCards() const;
+const CardSet& getCardSet() const;          //Returns the cards as a bit set without copying them
 int size() const;
+bool empty() const { return Count == 0; }   //True for a pass
+//Walks the cards in the order they were added
+const Card* begin() const { return Cards; }
+const Card* end() const { return Cards + Count; }
 };
 //Default constructor as a placeholder
 PlayingHand::PlayingHand()
@@ -286,7 +235,19 @@ PlayingHand::PlayingHand()
 }
 PlayingHand::PlayingHand(list<Card> Cs)
 {
-    Cards = Cs;
+    addToHand(Cs);
+}
+PlayingHand::PlayingHand(CardSet Cs)
+{
+    if (Cs.size() > MAX_CARDS) {
+        throw runtime_error("A hand holds at most " + to_string(MAX_CARDS) + " cards");
+    }
+    for (const auto& card : Cs)
+    {
+        Cards[Count++] = card;
+        countCard(card, 1);
+    }
+    Members = Cs;
 }
 //Default destructor as a placeholder
 PlayingHand::~PlayingHand()
@@ -296,17 +257,35 @@ PlayingHand::~PlayingHand()
 //Adds a card to the hand
 void PlayingHand::addToHand(Card C)
 {
-    Cards.push_back(C);
+    if (Count == MAX_CARDS) {
+        throw runtime_error("A hand holds at most " + to_string(MAX_CARDS) + " cards");
+    }
+    Cards[Count++] = C;
+    Members.add(C);
+    countCard(C, 1);
+    isEvaluated = false;
+}
+void PlayingHand::eraseAt(int I)
+{
+    Members.remove(Cards[I]);
+    countCard(Cards[I], -1);
+    for (int i = I + 1; i < Count; i++)
+    {
+        Cards[i - 1] = Cards[i];
+    }
+    Count--;
+    isEvaluated = false;
 }
 //Removes a certain card out of the hand
 Card PlayingHand::removeCardFromPlay(int I)
 {
-    if(I >= 0 && I < Cards.size())
+    if(I < 0 || I >= Count)
     {
-        list<Card>::iterator it = Cards.begin();
-        advance(it, I);
-        return *it;
+        throw runtime_error("Invalid card index: " + to_string(I) + " (hand size: " + to_string(Count) + ")");
     }
+    Card C = Cards[I];
+    eraseAt(I);
+    return C;
 }
 //Removes a set of card in the hand
 list<Card> PlayingHand::removeCardsFromPlay(list<int> selection)
@@ -314,304 +293,83 @@ list<Card> PlayingHand::removeCardsFromPlay(list<int> selection)
     std::list<Card> temp;
 
     // Convert selection of indices to actual Card objects
-    auto it = Cards.begin();
     for (const auto& i : selection)
     {
-        std::advance(it, i);  // Move iterator to the desired index
-        temp.push_back(*it);  // Add the selected card to temp
-        it = Cards.begin();  // Reset iterator to beginning for next selection
+        if (i < 0 || i >= Count) {
+            throw runtime_error("Invalid card index: " + to_string(i) + " (hand size: " + to_string(Count) + ")");
+        }
+        temp.push_back(Cards[i]);  // Add the selected card to temp
     }
 
-    // Now remove selected cards from the original deck
+    // Now remove selected cards from the original hand
     for (const auto& card : temp)
     {
-        auto removeIt = std::find(Cards.begin(), Cards.end(), card);
-        if (removeIt != Cards.end()) {
-            Cards.erase(removeIt);  // Remove the card from the deck
+        const Card* found = std::find(begin(), end(), card);
+        if (found != end()) {
+            eraseAt(static_cast<int>(found - Cards));
         }
     }
 
+    isEvaluated = false;
     return temp;  // Return the list of selected cards
 }
 //This discards the whole hand
 list<Card> PlayingHand::discardHand()
 {
-    list<Card> temp = Cards;
-    Cards.clear();
+    list<Card> temp(begin(), end());
+    Count = 0;
+    Members.clear();
+    fill(rankCount, rankCount + 13, 0);
+    fill(suitCount, suitCount + 4, 0);
+    isEvaluated = false;
     return temp;
 }
-//Checks if this is a high card
-bool PlayingHand::isHighCard()
-{
-    return Cards.size() == 1;
-}
-//Checks if this is a pair
-bool PlayingHand::isPair()
-{
-    if (Cards.size() != 2) return false;
-    
-    bool isPair = false;
-    for(const auto& Check : CardRankAmount)
-    {
-        if(Check.second == 2)
-        {
-            isPair = true;
-        }
-    }
-    return isPair;
-}
-//Checks if this is a two pair
-bool PlayingHand::isTwoPair()
-{
-    if (Cards.size() != 4) return false;
-    
-    int amountOfPairs = 0;
-    for(const auto& Check : CardRankAmount)
-    {
-        if(Check.second == 2)
-        {
-            amountOfPairs++;
-        }
-    }
-    return amountOfPairs == 2;
-}
-//Checks if the hand is a three of a kind
-bool PlayingHand::isThreeOfAKind()
-{
-    if (Cards.size() != 3) return false;
-    
-    bool isThreeOfAKind = false;
-    for(const auto& Check : CardRankAmount)
-    {
-        if(Check.second == 3)
-        {
-            isThreeOfAKind = true;
-        }
-    }
-    return isThreeOfAKind;
-}
-//Checks if the hand is a straight
-bool PlayingHand::isStraight()
-{
-    if (Cards.size() != 5) return false;
-    
-    list<int> temp = Sequence;
-    bool isStraight = true;
-    temp.sort();
-    temp.unique();
-    //Checks if this is indeed a five carder straight
-    if(temp.size() < 5) isStraight = false;
-    //Now check if this is a valid sequence
-    auto it = temp.begin();
-    auto next = std::next(it);
-    while(next != temp.end())
-    {
-        if(*next != *it + 1) isStraight = false;
-        ++it;
-        ++next;
-    }
-    return isStraight;
-}
-//Checks if this hand is a flush
-bool PlayingHand::isFlush()
-{
-    if (Cards.size() != 5) return false;
-    
-    // Check if all cards have the same suit
-    int firstSuit = Cards.front().getSuit();
-    for (const auto& card : Cards) {
-        if (card.getSuit() != firstSuit) {
-            return false;
-        }
-    }
-    return true;
-}
-//Checks if this hand is a full house
-bool PlayingHand::isFullHouse()
-{
-    if (Cards.size() != 5) return false;
-    
-    bool hasThree = false;
-    bool hasPair = false;
-    
-    for(const auto& Check : CardRankAmount)
-    {
-        if(Check.second == 3) hasThree = true;
-        if(Check.second == 2) hasPair = true;
-    }
-    
-    return hasThree && hasPair;
-}
-//Check if this hand is a four of a kind
-bool PlayingHand::isFourOfAKind()
-{
-    if (Cards.size() != 5) return false;
-    
-    bool isFourOfAKind = false;
-    for(const auto& Check : CardRankAmount)
-    {
-        if(Check.second == 4)
-        {
-            isFourOfAKind = true;
-        }
-    }
-    return isFourOfAKind;
-}
-//Checks if the hand is a straight flush
-bool PlayingHand::isStraightFlush()
-{
-    if (Cards.size() != 5) return false;
-    return isStraight() && isFlush();
-}
-//Checks if the hand is a royal flush
-bool PlayingHand::isRoyalFlush()
-{
-    if (Cards.size() != 5) return false;
-    
-    if (!isStraightFlush()) return false;
-    
-    // Check if highest card is Ace (rank 12)
-    return *max_element(Sequence.begin(), Sequence.end()) == 12;
-}
-//Takes the cards data and extracts key data for evaluation
-void PlayingHand::evaluateData()
-{
-    for(const auto& Card : Cards)
-    {
-        Sequence.push_back(Card.getCard());
-        CardRankAmount[Card.getCard()]++;
-        CardSuitAmount[Card.getSuit()]++;
-    }
-}
-//Evaluates the hand to return the type of hand is played, hand rank, and hand suit rank
-int PlayingHand::evaluateHandType()
+//Gets certain values used for comparisons and debugging
+//Names shared by everything that prints a hand type
+const char* PlayingHand::handTypeName(int type)
 {
-    //Check hand type
-    int hand = 0;
-    if(isRoyalFlush())
-    {
-        hand = 10;
-    }
-    else if (isStraightFlush())
-    {
-        hand = 9;
-    }
-    else if (isFourOfAKind())
-    {
-        hand = 8;
-    }
-    else if (isFullHouse())
-    {
-        hand = 7;
-    }
-    else if (isFlush())
-    {
-        hand = 6;
-    }
-    else if (isStraight())
-    {
-        hand = 5;
-    }
-    else if (isThreeOfAKind())
-    {
-        hand = 4;
-    }
-    else if (isTwoPair())
-    {
-        hand = 3;
-    }
-    else if (isPair())
-    {
-        hand = 2;
-    }
-    else if (isHighCard())
-    {
-        hand = 1;
-    }
-    else 
-    {
-        hand = 0;
-    }
-    return hand;
+    static constexpr const char* HAND_TYPE_NAMES[11] = {
+        "Skip", "High Card", "Pair", "Two Pair", "Three Of A Kind", "Straight",
+        "Flush", "Full House", "Four Of A Kind", "Straight Flush", "Royal Flush"};
+    return type >= 0 && type <= 10 ? HAND_TYPE_NAMES[type] : "";
 }
-//Gets certain values used for comparisons and debugging
-int PlayingHand::getHandType()
+int PlayingHand::getHandType() const
 {
+    refreshEvaluation();
     return handType;
 }
-int PlayingHand::getHighestCardRank()
+int PlayingHand::getHighestCardRank() const
 {
+    refreshEvaluation();
     return highestCardRank;
 }
-int PlayingHand::getHighestHandSuit()
+int PlayingHand::getHighestHandSuit() const
 {
+    refreshEvaluation();
     return highestHandSuit;
 }
-//Evaluates highest card rank
-int PlayingHand::evalHighestCardRank()
+uint32_t PlayingHand::getOrderKey() const
 {
-    switch (handType)
-    {
-        case 1: // High card
-            return *max_element(Sequence.begin(), Sequence.end());
-
-        case 2: // Pair
-        case 3: // Two Pair
-        case 4: // Three of a Kind
-        case 7: // Full House
-        case 8: // Four of a Kind:
-        {
-            int maxRank = -1;
-            for (const auto& pair : CardRankAmount)
-            {
-                if (pair.second > 1 && pair.first > maxRank)
-                    maxRank = pair.first;
-            }
-            return maxRank;
-        }
-
-        case 5: // Straight
-        case 9: // Straight Flush
-        case 10: // Royal Flush
-            return *max_element(Sequence.begin(), Sequence.end());
-
-        case 6: // Flush
-        {
-            int dominantSuit = evalHighestCardSuit();
-            int maxFlushRank = -1;
-            for (const auto& card : Cards)
-            {
-                if (card.getSuit() == dominantSuit && card.getCard() > maxFlushRank)
-                    maxFlushRank = card.getCard();
-            }
-            return maxFlushRank;
-        }
-
-        default:
-            return -1;
-    }
+    refreshEvaluation();
+    return orderKey;
 }
-//Evaluates highest suit rank
-int PlayingHand::evalHighestCardSuit()
+//Classifies the cards with the table driven evaluator (see HandEvaluator.h)
+void PlayingHand::evaluateHand()
 {
-    if (CardSuitAmount.empty()) return -1;
-
-    auto maxIt = max_element(CardSuitAmount.begin(), CardSuitAmount.end(),
-        [](const pair<int, int>& a, const pair<int, int>& b) {
-            if (a.second != b.second)
-                return a.second < b.second; // compare by count
-            return a.first < b.first; // tie-break by higher suit value
-        });
-
-    return maxIt->first; // returns the suit (key) with the highest count (value)
+    LATENCY_SCOPE(LatencyProbe::EvaluateHand);
+    refreshEvaluation();
 }
-void PlayingHand::evaluateHand()
+void PlayingHand::refreshEvaluation() const
 {
-    clearPriorEval();
-    evaluateData();
-    handType = evaluateHandType();
-    highestCardRank = evalHighestCardRank();
-    highestHandSuit = evalHighestCardSuit();
+    if (isEvaluated) {
+        return;
+    }
+    HandEvaluation eval = HandEvaluator::evaluate(Members);
+    handType = eval.handType;
+    highestCardRank = eval.highestCardRank;
+    highestHandSuit = eval.highestHandSuit;
+    orderKey = HandEvaluator::orderKey(eval, Count);
+    isEvaluated = true;
 }
 void PlayingHand::displayHand() const
 {
@@ -622,24 +380,10 @@ void PlayingHand::displayHand() const
         cout << endl;
     }
 }
-void PlayingHand::clearPriorEval()
-{
-    Sequence.clear();                     
-    CardRankAmount.clear();  
-    CardSuitAmount.clear(); 
-    //Set default values for hand attributes
-    handType = -1;           //Indicates the hand type singles, royal flush      (0-10)
-    highestCardRank = -1;    //Indicates the highest card rank (when applicable) (1-13)
-    highestHandSuit = -1;    //Indicates the highest hand suit (when applicable) (1-4)
-}
 bool PlayingHand::operator==(const PlayingHand& other) const {
-    PlayingHand lhs = *this;
-    PlayingHand rhs = other;
-    lhs.evaluateHand();
-    rhs.evaluateHand();
-    return lhs.handType == rhs.handType &&
-           lhs.highestCardRank == rhs.highestCardRank &&
-           lhs.highestHandSuit == rhs.highestHandSuit;
+    return getHandType() == other.getHandType() &&
+           getHighestCardRank() == other.getHighestCardRank() &&
+           getHighestHandSuit() == other.getHighestHandSuit();
 }
 
 bool PlayingHand::operator!=(const PlayingHand& other) const {
@@ -647,16 +391,7 @@ bool PlayingHand::operator!=(const PlayingHand& other) const {
 }
 
 bool PlayingHand::operator<(const PlayingHand& other) const {
-    PlayingHand lhs = *this;
-    PlayingHand rhs = other;
-    lhs.evaluateHand();
-    rhs.evaluateHand();
-
-    if (lhs.handType != rhs.handType)
-        return lhs.handType < rhs.handType;
-    if (lhs.highestCardRank != rhs.highestCardRank)
-        return lhs.highestCardRank < rhs.highestCardRank;
-    return lhs.highestHandSuit < rhs.highestHandSuit;
+    return getOrderKey() < other.getOrderKey();
 }
 
 bool PlayingHand::operator>(const PlayingHand& other) const {
@@ -672,17 +407,21 @@ bool PlayingHand::operator>=(const PlayingHand& other) const {
 }
 list<Card> PlayingHand::getCards() const
 {
-    return Cards;
+    return list<Card>(begin(), end());
+}
+const CardSet& PlayingHand::getCardSet() const
+{
+    return Members;
 }
 void PlayingHand::addToHand(list<Card> Cs)
 {
      for (const auto& card : Cs)
         {
-            Cards.push_back(card);
+            addToHand(card);
         }
 }
 int PlayingHand::size() const
 {
-    return Cards.size();
+    return Count;
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <array>
+#include <cstdint>
+#include <limits>
+using namespace std;
+
+//---STREAMS---
+//Every game of a run draws from its own streams, named by the game number and
+//a purpose, so game i can be replayed from (master seed, i) alone
+const int STREAM_DEAL = 0;          //Shuffles and deals of the deck
+const int STREAM_TABLE = 1;         //Per game values of the table (the endgame table salt)
+const int STREAM_SEAT = 2;          //AI searches of a seat (STREAM_SEAT + seat)
+inline uint64_t gameStream(uint64_t game, int purpose)
+{
+    return (game << 8) | static_cast<uint64_t>(purpose);
+}
+
+//Steps a splitmix64 state and returns the next output, used to spread one seed over a whole engine state
+inline uint64_t splitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+//Uniform number in [0, bound) from an engine with next32, without a division
+//(Lemire's multiply and reject)
+template <class Engine>
+uint32_t uniformBelow(Engine& engine, uint32_t bound)
+{
+    uint64_t product = static_cast<uint64_t>(engine.next32()) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound) {
+        uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+        while (low < threshold)
+        {
+            product = static_cast<uint64_t>(engine.next32()) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+//xoshiro256** by Blackman and Vigna: 32 bytes of state, a few instructions a
+//number, and seeding is four splitmix64 steps (mt19937 fills 2.5 KB), so one
+//engine can be reseeded for every game. Works with the <random> algorithms.
+class Xoshiro256
+{
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    using result_type = uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return numeric_limits<uint64_t>::max(); }
+
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+    void reseed(uint64_t seed)
+    {
+        for (auto& word : s)
+        {
+            word = splitMix64(seed);
+        }
+    }
+    uint64_t operator()()
+    {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+    //The high 32 bits of the next number (the best ones of xoshiro)
+    uint32_t next32() { return static_cast<uint32_t>((*this)() >> 32); }
+    uint32_t below(uint32_t bound) { return uniformBelow(*this, bound); }
+};
+
+//Philox4x32-10 by Salmon et al. (Random123), a counter based generator: block n
+//of a stream is ten rounds of multiply and xor over the 128 bit counter
+//(n, stream) keyed by the seed. Nothing is carried from one block to the next,
+//so any stream can be started anywhere without playing the others.
+class Philox4x32
+{
+private:
+    static constexpr uint32_t MULTIPLIER_0 = 0xD2511F53;
+    static constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+    static constexpr uint32_t KEY_STEP_0 = 0x9E3779B9;     //Golden ratio
+    static constexpr uint32_t KEY_STEP_1 = 0xBB67AE85;     //sqrt(3) - 1
+    static constexpr int ROUNDS = 10;
+
+    uint64_t seed;
+    uint64_t stream;
+    uint64_t block = 0;         //Counter of the next block
+    array<uint32_t, 4> output;  //Words of the last block
+    int used = 4;               //Words of output already handed out
+
+public:
+    using result_type = uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return numeric_limits<uint64_t>::max(); }
+
+    explicit Philox4x32(uint64_t seed = 0, uint64_t stream = 0) : seed(seed), stream(stream) {}
+    //Block n of a stream
+    static array<uint32_t, 4> generate(uint64_t seed, uint64_t stream, uint64_t n);
+
+    uint32_t next32()
+    {
+        if (used == 4) {
+            output = generate(seed, stream, block++);
+            used = 0;
+        }
+        return output[used++];
+    }
+    uint64_t operator()()
+    {
+        uint64_t high = next32();
+        return (high << 32) | next32();
+    }
+    uint32_t below(uint32_t bound) { return uniformBelow(*this, bound); }
+};
+
+inline array<uint32_t, 4> Philox4x32::generate(uint64_t seed, uint64_t stream, uint64_t n)
+{
+    uint32_t counter[4] = {static_cast<uint32_t>(n), static_cast<uint32_t>(n >> 32),
+                           static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)};
+    uint32_t key[2] = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        uint64_t product0 = static_cast<uint64_t>(MULTIPLIER_0) * counter[0];
+        uint64_t product1 = static_cast<uint64_t>(MULTIPLIER_1) * counter[2];
+        uint32_t next[4] = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                            static_cast<uint32_t>(product1),
+                            static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                            static_cast<uint32_t>(product0)};
+        for (int i = 0; i < 4; i++) counter[i] = next[i];
+        key[0] += KEY_STEP_0;
+        key[1] += KEY_STEP_1;
+    }
+    return {counter[0], counter[1], counter[2], counter[3]};
+}
+
+#endif
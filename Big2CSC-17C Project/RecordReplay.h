@@ -0,0 +1,217 @@
+#ifndef RECORDREPLAY_H
+#define RECORDREPLAY_H
+#include "GameEngine.h"
+#include "GameRecord.h"
+#include "Player.h"
+#include "WorkStealingPool.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+const int REPLAY_HAND_TYPES = 11;           //Hand types 0-10 (see PlayingHand::handTypeName)
+const int REPLAY_BATCH_GAMES = 4096;        //Games per unit of work of the replay pool
+
+//Totals over replayed games
+struct ReplayStats
+{
+    long long games = 0;
+    long long turns = 0;
+    long long leads = 0;                    //Plays made with nothing to beat
+    long long plays = 0;                    //Leads included
+    long long passes = 0;
+    long long playsByType[REPLAY_HAND_TYPES] = {};
+    long long cardsPlayed = 0;
+    long long passesWithBeat[GAME_SEATS] = {};  //Passes while holding a play that beat the table
+    long long rulePasses = 0;               //Passes where Player::passRule says pass
+    long long rulePassesWithBeat = 0;       //... and a beating play was held
+    long long wins[GAME_SEATS] = {};
+    long long unfinished = 0;
+    long long badDeals = 0;                 //Deals that are not four disjoint hands with the 3 of clubs
+    long long illegalMoves = 0;             //The rest of such a game is not replayed
+    long long wrongWinners = 0;             //Recorded winner differs from the replayed one
+    long long malformed = 0;                //Games with a turn entry that is not a card or a pass
+
+    long long errors() const { return badDeals + illegalMoves + wrongWinners + malformed; }
+    void merge(const ReplayStats& other)
+    {
+        games += other.games;
+        turns += other.turns;
+        leads += other.leads;
+        plays += other.plays;
+        passes += other.passes;
+        for (int i = 0; i < REPLAY_HAND_TYPES; i++)
+        {
+            playsByType[i] += other.playsByType[i];
+        }
+        cardsPlayed += other.cardsPlayed;
+        for (int seat = 0; seat < GAME_SEATS; seat++)
+        {
+            passesWithBeat[seat] += other.passesWithBeat[seat];
+            wins[seat] += other.wins[seat];
+        }
+        rulePasses += other.rulePasses;
+        rulePassesWithBeat += other.rulePassesWithBeat;
+        unfinished += other.unfinished;
+        badDeals += other.badDeals;
+        illegalMoves += other.illegalMoves;
+        wrongWinners += other.wrongWinners;
+        malformed += other.malformed;
+    }
+};
+
+//Totals and timing of one replay of a file
+struct ReplayResult
+{
+    ReplayStats stats;
+    int threads = 1;
+    double seconds = 0;
+    size_t bytes = 0;           //Size of the file
+
+    double gamesPerSecond() const { return seconds > 0 ? stats.games / seconds : 0; }
+    double megabytesPerSecond() const { return seconds > 0 ? bytes / seconds / 1e6 : 0; }
+};
+
+//True when hand holds a play that beats the top of state. Every play takes
+//its rank from one of its cards and only a higher rank beats (see
+//HandEvaluator::beats), so the highest card of the hand settles singles and
+//rules out most other tops before any move is listed.
+inline bool holdsBeatingPlay(CardSet hand, const GameState& state, MoveList& candidates, uint32_t* keys)
+{
+    int size = state.top.size();
+    int highestRank = hand.highestIndex() / 4 + 1;
+    if (hand.size() < size || highestRank <= HandEvaluator::rankOf(state.topKey)) {
+        return false;
+    }
+    if (size == 1) {
+        return true;
+    }
+    MoveGenerator::generateOfSize(hand, size, candidates);
+    BatchEvaluator::orderKeys(candidates.data(), candidates.size(), keys);
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        if (HandEvaluator::beats(keys[i], state.topKey)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//Plays a recorded game again through GameEngine, checking every turn against
+//the rules, and adds what happened to stats
+inline void replayGame(const GameRecordView& game, ReplayStats& stats)
+{
+    stats.games++;
+    CardSet dealt;
+    bool disjoint = true;
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        disjoint = disjoint && (dealt & game.hands[seat]).empty();
+        dealt.add(game.hands[seat]);
+    }
+    if (!disjoint || !dealt.containsIndex(0)) {
+        stats.badDeals++;
+        return;
+    }
+
+    GameState state = GameEngine::newGame(game.hands);
+    MoveList candidates;
+    uint32_t keys[MoveList::MAX_MOVES];
+    CardSet move;
+    for (const uint8_t* at = game.turns; at < game.turnsEnd; )
+    {
+        at = game.readTurn(at, move);
+        stats.turns++;
+        CardSet hand = state.hands[state.seat];
+        bool legal;
+        if (GameEngine::isTerminal(state)) {
+            legal = false;
+        } else if (move.empty()) {
+            legal = !state.top.empty();
+        } else {
+            uint32_t key = HandEvaluator::orderKey(move);
+            legal = (move - hand).empty() && HandEvaluator::typeOf(key) != 0 &&
+                    (state.top.empty() || HandEvaluator::beats(key, state.topKey));
+            if (legal) {
+                stats.plays++;
+                stats.leads += state.top.empty() ? 1 : 0;
+                stats.playsByType[HandEvaluator::typeOf(key)]++;
+                stats.cardsPlayed += move.size();
+            }
+        }
+        if (!legal) {
+            stats.illegalMoves++;
+            return;
+        }
+
+        if (move.empty()) {
+            stats.passes++;
+            bool couldBeat = holdsBeatingPlay(hand, state, candidates, keys);
+            bool rule = Player::passRule(hand.size(), HandEvaluator::typeOf(state.topKey));
+            stats.passesWithBeat[state.seat] += couldBeat ? 1 : 0;
+            stats.rulePasses += rule ? 1 : 0;
+            stats.rulePassesWithBeat += rule && couldBeat ? 1 : 0;
+        }
+        GameEngine::apply(state, move);
+    }
+
+    int winner = GameEngine::winner(state);
+    if (winner != game.winner) {
+        stats.wrongWinners++;
+    } else if (winner >= 0) {
+        stats.wins[winner]++;
+    } else {
+        stats.unfinished++;
+    }
+}
+
+//Replays every game of file on a work stealing pool. Records have no fixed
+//size, so one pass over the file first notes where every REPLAY_BATCH_GAMES
+//games start (only the record ends are looked at); the batches are then
+//replayed in parallel, each worker adding to its own statistics.
+inline ReplayResult replayRecords(const GameRecordFile& file, int threads)
+{
+    auto start = chrono::steady_clock::now();
+    vector<const uint8_t*> batches;
+    GameRecordCursor scan = file.records();
+    GameRecordView game;
+    for (long long count = 0; ; count++)
+    {
+        if (count % REPLAY_BATCH_GAMES == 0) {
+            batches.push_back(scan.position());
+        }
+        if (!scan.next(game)) break;
+    }
+    if (batches.back() != file.recordsEnd()) {
+        batches.push_back(file.recordsEnd());
+    }
+
+    WorkStealingPool pool(threads);
+    vector<ReplayStats> workers(pool.size());
+    long long batchCount = static_cast<long long>(batches.size()) - 1;
+    pool.parallelFor(batchCount, 1, [&](int worker, long long index) {
+        GameRecordCursor cursor(batches[index], batches[index + 1]);
+        GameRecordView view;
+        while (cursor.next(view))
+        {
+            // A worker thread must not throw, a bad turn entry only spoils its own game
+            try {
+                replayGame(view, workers[worker]);
+            } catch (const runtime_error&) {
+                workers[worker].malformed++;
+            }
+        }
+    });
+
+    ReplayResult result;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.threads = pool.size();
+    result.bytes = file.size();
+    for (const auto& stats : workers)
+    {
+        result.stats.merge(stats);
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+#include "Deck.h"
+#include "GameRecord.h"
+#include "Player.h"
+#include "PlayingHand.h"
+#include "Trace.h"
+using namespace std;
+
+const int SIM_PLAYERS = 4;          //Seats at the table, all of them AI
+const int SIM_MAX_TURNS = 1000;     //Safety net, a real game ends far sooner
+
+//Outcome of a single headless game
+struct GameResult
+{
+    int winner;     //Seat (0-3) that ran out of cards, -1 if the turn limit was hit
+    int turns;      //Turns taken, passes included
+};
+
+//Totals over many headless games
+struct SimulationStats
+{
+    long long games = 0;
+    long long wins[SIM_PLAYERS] = {};
+    long long turns = 0;
+    long long unfinished = 0;
+
+    void record(const GameResult& result)
+    {
+        games++;
+        turns += result.turns;
+        if (result.winner >= 0) {
+            wins[result.winner]++;
+        } else {
+            unfinished++;
+        }
+    }
+    void merge(const SimulationStats& other)
+    {
+        games += other.games;
+        turns += other.turns;
+        unfinished += other.unfinished;
+        for (int i = 0; i < SIM_PLAYERS; i++)
+        {
+            wins[i] += other.wins[i];
+        }
+    }
+};
+
+//Which AI plays each seat
+struct TableSetup
+{
+    AiMode modes[SIM_PLAYERS] = {AiMode::Heuristic, AiMode::Heuristic, AiMode::Heuristic, AiMode::Heuristic};
+    MctsConfig mcts;        //Budget of every Mcts seat
+    EndgameConfig endgame;  //Exact solver shared by the seats (cardThreshold 0 turns it off)
+};
+
+//A table of four quiet AI players that can play game after game.
+//Simulation workers keep one table each so the Deck and Player objects are reused.
+class HeadlessTable
+{
+private:
+    Deck deck;
+    Player players[SIM_PLAYERS] = {Player(true), Player(true), Player(true), Player(true)};
+    shared_ptr<EndgameSolver> endgame;      //One transposition table for the whole table
+
+public:
+    HeadlessTable(const TableSetup& setup = TableSetup());
+    GameResult playGame(uint64_t seed, uint64_t game, GameRecordBuffer* record = nullptr);
+    EndgameStats endgameStats() const { return endgame ? endgame->getStats() : EndgameStats(); }
+};
+
+HeadlessTable::HeadlessTable(const TableSetup& setup)
+{
+    deck.fillDeck();
+    for (int i = 0; i < SIM_PLAYERS; i++)
+    {
+        players[i].setQuiet(true);
+        players[i].setAiMode(setup.modes[i], setup.mcts);
+    }
+    if (setup.endgame.cardThreshold > 0) {
+        endgame = make_shared<EndgameSolver>(setup.endgame);
+        for (auto& player : players)
+        {
+            player.setEndgameSolver(endgame);
+        }
+    }
+}
+
+//Plays one game with the same rules as main.cpp: the 3 of clubs leads, three
+//passes in a row start a new round led by the last player to play, and the
+//first player out of cards wins. Game number game of a run seeded with seed
+//draws only from its own streams (see Random.h), so it is always the same game
+//whatever the table played before (for Mcts seats with iteration budgets).
+//When record is given the deal, every turn and the winner are appended to it.
+GameResult HeadlessTable::playGame(uint64_t seed, uint64_t game, GameRecordBuffer* record)
+{
+    TRACE_SCOPE_ARG("game", "game", static_cast<long long>(game));
+    // Deal one card at a time like the table does, the deck keeps its 52 cards for the next game
+    CardSet hands[SIM_PLAYERS];
+    deck.seed(seed, gameStream(game, STREAM_DEAL));
+    deck.dealHands(SIM_PLAYERS, 13, hands);
+    for (int i = 0; i < SIM_PLAYERS; i++)
+    {
+        players[i].clearCards();
+        players[i].addToPlayerHand(hands[i]);
+        players[i].seedAi(seed, gameStream(game, STREAM_SEAT + i));
+    }
+    if (endgame) {
+        endgame->startGame(Philox4x32(seed, gameStream(game, STREAM_TABLE))());
+    }
+
+    // The player with the 3 of clubs starts, GameEngine keeps track of the rest
+    GameState state = GameEngine::newGame(hands);
+    if (record) {
+        record->beginGame(game, hands);
+    }
+
+    GameResult result = {-1, SIM_MAX_TURNS};
+    for (int turn = 1; turn <= SIM_MAX_TURNS; turn++)
+    {
+        LATENCY_SCOPE(LatencyProbe::Turn);
+        int seat = state.seat;
+        TRACE_SCOPE_ARG("turn", "seat", seat);
+        PlayingHand playedHand = players[seat].decision(PlayingHand(state.top), GameEngine::viewFor(state));
+        GameEngine::apply(state, playedHand.getCardSet());
+        if (record) {
+            record->addMove(playedHand.getCardSet());
+        }
+        if (GameEngine::isTerminal(state)) {
+            result = {seat, turn};
+            break;
+        }
+    }
+    if (record) {
+        record->endGame(result.winner);
+    }
+    return result;
+}
+
+//Plays a single game on a fresh table
+inline GameResult playHeadlessGame(uint64_t seed, uint64_t game)
+{
+    HeadlessTable table;
+    return table.playGame(seed, game);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+#include "Simulation.h"
+#include "WorkStealingPool.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+using namespace std;
+
+//Totals and timing of one multi-threaded run
+struct TournamentResult
+{
+    SimulationStats stats;
+    EndgameStats endgame;       //Work of the endgame solvers of every table
+    int threads = 1;
+    double seconds = 0;
+
+    double gamesPerSecond() const { return seconds > 0 ? stats.games / seconds : 0; }
+};
+
+//Threads the machine can run at once (at least 1)
+inline int hardwareThreads()
+{
+    unsigned int count = thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+//Plays games 0 .. games-1 spread over a work stealing pool. Game i only draws
+//from the streams of (seed, i), so the totals do not depend on which thread played what.
+//Every worker owns its table and its statistics; they are only added together
+//after all threads have finished. With records every game is also written to
+//it, each worker collects RECORD_FLUSH_BYTES of games before handing them over.
+inline TournamentResult runTournament(long long games, uint64_t seed, int threads,
+                                      const TableSetup& setup = TableSetup(),
+                                      GameRecordWriter* records = nullptr)
+{
+    const size_t RECORD_FLUSH_BYTES = 64 << 10;
+
+    struct WorkerState
+    {
+        HeadlessTable table;
+        SimulationStats stats;
+        GameRecordBuffer record;
+
+        explicit WorkerState(const TableSetup& setup) : table(setup) {}
+    };
+
+    WorkStealingPool pool(threads);
+    vector<unique_ptr<WorkerState>> workers;
+    for (int i = 0; i < pool.size(); i++)
+    {
+        workers.push_back(make_unique<WorkerState>(setup));
+    }
+
+    // Small chunks keep the load even, large enough to make stealing rare
+    long long chunkSize = games / (static_cast<long long>(pool.size()) * 16);
+    if (chunkSize < 1) chunkSize = 1;
+
+    auto start = chrono::steady_clock::now();
+    pool.parallelFor(games, chunkSize, [&](int worker, long long index) {
+        WorkerState& state = *workers[worker];
+        state.stats.record(state.table.playGame(seed, static_cast<uint64_t>(index),
+                                                records ? &state.record : nullptr));
+        if (records && state.record.size() >= RECORD_FLUSH_BYTES) {
+            records->write(state.record);
+        }
+    });
+    if (records) {
+        for (auto& state : workers)
+        {
+            records->write(state->record);
+        }
+    }
+
+    TournamentResult result;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.threads = pool.size();
+    for (const auto& state : workers)
+    {
+        result.stats.merge(state->stats);
+        result.endgame.merge(state->table.endgameStats());
+    }
+    return result;
+}
+
+#endif
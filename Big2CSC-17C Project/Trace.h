@@ -0,0 +1,298 @@
+#ifndef TRACE_H
+#define TRACE_H
+#include <string>
+using namespace std;
+
+//Timeline of games, turns, AI phases and console output in the Chrome trace
+//event format (open it in chrome://tracing or ui.perfetto.dev). Built in with
+//-DBIG2_TRACE=1 and recorded between Tracer::start(path) and Tracer::stop().
+//Without the flag the TRACE_ macros expand to nothing.
+#ifndef BIG2_TRACE
+#define BIG2_TRACE 0
+#endif
+
+#if BIG2_TRACE
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+//One finished span
+struct TraceEvent
+{
+    const char* name;       //String literals only, the flusher reads them later
+    const char* argName;    //nullptr without an argument
+    long long arg;
+    uint64_t start;         //Nanoseconds since Tracer::start
+    uint64_t duration;
+};
+
+//Fixed size queue of the spans of one thread: the thread adds at head, the
+//flusher thread takes from tail. A full ring drops the new span and counts it.
+class TraceRing
+{
+public:
+    static const uint64_t CAPACITY = 1 << 18;     //Power of 2 (10 MB a thread)
+
+    int thread;                 //Trace thread id
+    atomic<uint64_t> dropped{0};
+
+    //Left uninitialized, the pages are only touched as the ring fills
+    explicit TraceRing(int thread) : thread(thread), events(new TraceEvent[CAPACITY]) {}
+    void push(const TraceEvent& event)
+    {
+        uint64_t h = head.load(memory_order_relaxed);
+        if (h - tail.load(memory_order_acquire) == CAPACITY) {
+            dropped.store(dropped.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            return;
+        }
+        events[h & (CAPACITY - 1)] = event;
+        head.store(h + 1, memory_order_release);
+    }
+    //Hands every queued span to write, only called by the flusher
+    template <class Write>
+    void drain(Write write)
+    {
+        uint64_t t = tail.load(memory_order_relaxed);
+        uint64_t h = head.load(memory_order_acquire);
+        for (; t != h; t++)
+        {
+            write(events[t & (CAPACITY - 1)]);
+        }
+        tail.store(t, memory_order_release);
+    }
+
+private:
+    unique_ptr<TraceEvent[]> events;
+    atomic<uint64_t> head{0};
+    atomic<uint64_t> tail{0};
+};
+
+//The trace file and the thread that empties every ring into it
+class Tracer
+{
+private:
+    static const int FLUSH_MS = 10;         //How often the rings are emptied
+
+    atomic<bool> running{false};
+    chrono::steady_clock::time_point origin;
+    FILE* file = nullptr;
+    string path;
+    bool firstEvent = true;
+    mutex ringsLock;                        //Taken when a thread traces its first span and by the flusher
+    vector<unique_ptr<TraceRing>> rings;    //Never freed, a finished thread's spans stay readable
+    thread flusher;
+    mutex stopLock;
+    condition_variable stopSignal;
+    bool stopping = false;
+
+    static Tracer& instance()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+    TraceRing& localRing();
+    void flush();
+    void writeEvent(const TraceEvent& event, int thread);
+
+public:
+    //Starts writing a trace to path, throws runtime_error if it cannot be opened
+    static void start(const string& path);
+    //Writes what is left and closes the file. Returns the spans dropped because a ring was full.
+    static unsigned long long stop();
+    static bool active() { return instance().running.load(memory_order_acquire); }
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - instance().origin).count());
+    }
+    static void record(const TraceEvent& event) { instance().localRing().push(event); }
+};
+
+//A span from its construction to the end of the scope (or to next)
+class TraceSpan
+{
+private:
+    const char* name;
+    const char* argName;
+    long long arg;
+    uint64_t start;
+    bool on;
+
+    void finish()
+    {
+        if (on) Tracer::record({name, argName, arg, start, Tracer::now() - start});
+    }
+
+public:
+    explicit TraceSpan(const char* name, const char* argName = nullptr, long long arg = 0)
+        : name(name), argName(argName), arg(arg), on(Tracer::active())
+    {
+        start = on ? Tracer::now() : 0;
+    }
+    ~TraceSpan() { finish(); }
+    //Ends this span and starts the next one of a sequence of phases
+    void next(const char* nextName)
+    {
+        finish();
+        name = nextName;
+        argName = nullptr;
+        start = on ? Tracer::now() : 0;
+    }
+    //Ends the span before the scope does
+    void end()
+    {
+        finish();
+        on = false;
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+inline TraceRing& Tracer::localRing()
+{
+    static thread_local TraceRing* mine = nullptr;
+    if (mine == nullptr) {
+        lock_guard<mutex> guard(ringsLock);
+        rings.push_back(make_unique<TraceRing>(static_cast<int>(rings.size()) + 1));
+        mine = rings.back().get();
+    }
+    return *mine;
+}
+//Writes nanoseconds as microseconds with three decimals (what Chrome wants) at out, returns the end
+inline char* formatMicros(char* out, uint64_t ns)
+{
+    char digits[24];
+    int count = 0;
+    uint64_t micros = ns / 1000;
+    do {
+        digits[count++] = static_cast<char>('0' + micros % 10);
+        micros /= 10;
+    } while (micros > 0);
+    while (count > 0) *out++ = digits[--count];
+    uint64_t fraction = ns % 1000;
+    *out++ = '.';
+    *out++ = static_cast<char>('0' + fraction / 100);
+    *out++ = static_cast<char>('0' + fraction / 10 % 10);
+    *out++ = static_cast<char>('0' + fraction % 10);
+    return out;
+}
+inline void Tracer::writeEvent(const TraceEvent& event, int thread)
+{
+    // Formatting is most of the flusher's work, so no printf for the numbers
+    char line[256];
+    char* out = line;
+    auto put = [&out](const char* text) { while (*text) *out++ = *text++; };
+    put(firstEvent ? "\n{\"name\":\"" : ",\n{\"name\":\"");
+    put(event.name);
+    put("\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+    out += snprintf(out, 16, "%d", thread);
+    put(",\"ts\":");
+    out = formatMicros(out, event.start);
+    put(",\"dur\":");
+    out = formatMicros(out, event.duration);
+    if (event.argName != nullptr) {
+        put(",\"args\":{\"");
+        put(event.argName);
+        put("\":");
+        out += snprintf(out, 24, "%lld", event.arg);
+        put("}");
+    }
+    put("}");
+    fwrite(line, 1, static_cast<size_t>(out - line), file);
+    firstEvent = false;
+}
+inline void Tracer::flush()
+{
+    lock_guard<mutex> guard(ringsLock);
+    for (auto& ring : rings)
+    {
+        int thread = ring->thread;
+        ring->drain([&](const TraceEvent& event) { writeEvent(event, thread); });
+    }
+}
+inline void Tracer::start(const string& tracePath)
+{
+    Tracer& tracer = instance();
+    if (tracer.file != nullptr) {
+        throw logic_error("A trace is already being written");
+    }
+    tracer.file = fopen(tracePath.c_str(), "w");
+    if (tracer.file == nullptr) {
+        throw runtime_error("Cannot open trace file " + tracePath);
+    }
+    tracer.path = tracePath;
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", tracer.file);
+    tracer.firstEvent = true;
+    tracer.stopping = false;
+    tracer.origin = chrono::steady_clock::now();
+    tracer.running.store(true);
+    tracer.flusher = thread([&tracer]() {
+        unique_lock<mutex> lock(tracer.stopLock);
+        while (!tracer.stopping)
+        {
+            tracer.stopSignal.wait_for(lock, chrono::milliseconds(FLUSH_MS));
+            tracer.flush();
+        }
+    });
+}
+inline unsigned long long Tracer::stop()
+{
+    Tracer& tracer = instance();
+    if (tracer.file == nullptr) {
+        return 0;
+    }
+    tracer.running.store(false);
+    {
+        lock_guard<mutex> guard(tracer.stopLock);
+        tracer.stopping = true;
+    }
+    tracer.stopSignal.notify_one();
+    tracer.flusher.join();
+    // Spans that were open when the trace stopped still land in the rings
+    tracer.flush();
+
+    unsigned long long dropped = 0;
+    lock_guard<mutex> guard(tracer.ringsLock);
+    for (const auto& ring : tracer.rings)
+    {
+        dropped += ring->dropped.load();
+        fprintf(tracer.file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                ring->thread, ring->thread);
+    }
+    fprintf(tracer.file, "\n],\"otherData\":{\"droppedSpans\":%llu}}\n", dropped);
+    bool failed = ferror(tracer.file) != 0;
+    failed = fclose(tracer.file) != 0 || failed;
+    tracer.file = nullptr;
+    if (failed) {
+        throw runtime_error("Cannot write trace file " + tracer.path);
+    }
+    return dropped;
+}
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+//A span over the rest of the scope
+#define TRACE_SCOPE(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, argName, arg) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name, argName, arg)
+//Consecutive phases of one scope: TRACE_PHASE(p, "generate") ... TRACE_NEXT(p, "filter") ...
+//(TRACE_END(p) closes the last one early)
+#define TRACE_PHASE(phase, name) TraceSpan phase(name)
+#define TRACE_NEXT(phase, name) phase.next(name)
+#define TRACE_END(phase) phase.end()
+
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_SCOPE_ARG(name, argName, arg)
+#define TRACE_PHASE(phase, name)
+#define TRACE_NEXT(phase, name)
+#define TRACE_END(phase)
+#endif
+
+#endif
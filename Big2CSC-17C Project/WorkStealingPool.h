@@ -0,0 +1,114 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <utility>
+using namespace std;
+
+//Runs task(worker, index) for every index in [0, count) on a group of threads.
+//The indices are cut into chunks and every worker starts with its own share of
+//them in its own queue. A worker takes chunks from the back of its queue and,
+//once it runs dry, steals from the front of another worker's queue, so fast
+//workers keep busy while slow ones finish. Each queue has its own lock, which
+//is only ever contended during a steal.
+class WorkStealingPool
+{
+private:
+    struct alignas(64) WorkerQueue
+    {
+        mutex lock;
+        deque<pair<long long, long long>> chunks;   //[begin, end) index ranges
+    };
+
+    int threadCount;
+
+    static bool popOwn(WorkerQueue& queue, pair<long long, long long>& chunk);
+    static bool steal(WorkerQueue& queue, pair<long long, long long>& chunk);
+
+public:
+    explicit WorkStealingPool(int threads);
+    int size() const { return threadCount; }
+
+    template <class Task>
+    void parallelFor(long long count, long long chunkSize, Task task);
+};
+
+inline WorkStealingPool::WorkStealingPool(int threads)
+{
+    threadCount = threads > 0 ? threads : 1;
+}
+inline bool WorkStealingPool::popOwn(WorkerQueue& queue, pair<long long, long long>& chunk)
+{
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.chunks.empty()) {
+        return false;
+    }
+    chunk = queue.chunks.back();
+    queue.chunks.pop_back();
+    return true;
+}
+inline bool WorkStealingPool::steal(WorkerQueue& queue, pair<long long, long long>& chunk)
+{
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.chunks.empty()) {
+        return false;
+    }
+    chunk = queue.chunks.front();
+    queue.chunks.pop_front();
+    return true;
+}
+template <class Task>
+void WorkStealingPool::parallelFor(long long count, long long chunkSize, Task task)
+{
+    if (count <= 0) {
+        return;
+    }
+    if (chunkSize <= 0) {
+        chunkSize = 1;
+    }
+
+    // Hand out contiguous runs of chunks, one run per worker
+    vector<WorkerQueue> queues(threadCount);
+    long long chunkCount = (count + chunkSize - 1) / chunkSize;
+    for (long long c = 0; c < chunkCount; c++)
+    {
+        long long begin = c * chunkSize;
+        long long end = begin + chunkSize < count ? begin + chunkSize : count;
+        queues[c * threadCount / chunkCount].chunks.emplace_back(begin, end);
+    }
+
+    auto worker = [&](int self) {
+        pair<long long, long long> chunk;
+        while (true)
+        {
+            bool found = popOwn(queues[self], chunk);
+            for (int i = 1; !found && i < threadCount; i++)
+            {
+                found = steal(queues[(self + i) % threadCount], chunk);
+            }
+            // No task ever adds work, so empty queues everywhere means we are done
+            if (!found) {
+                return;
+            }
+            for (long long index = chunk.first; index < chunk.second; index++)
+            {
+                task(self, index);
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
+
+#endif
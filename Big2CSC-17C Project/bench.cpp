@@ -0,0 +1,441 @@
+// big2_bench - microbenchmarks for the hand evaluation and AI hot paths
+// Usage: big2_bench [--filter TEXT] [--min-time SECONDS] [--allocator arena|default]
+//                   [--repeat N] [--save FILE] [--compare FILE] [--threshold PERCENT] [--alpha P]
+//   --allocator         where the tree search puts the temporaries of a move (MctsConfig::moveArena)
+//   --repeat N          time every benchmark N times (default 1, or 5 with --save or --compare)
+//   --save FILE         write the timings of every repetition to FILE as a baseline
+//   --compare FILE      compare with a saved baseline (see BenchmarkBaseline.h); a TRACKED
+//                       benchmark whose median is more than --threshold percent (default 5)
+//                       slower with a Mann-Whitney p-value below --alpha (default 0.05) regresses
+// Prints one JSON object per benchmark (see Benchmark.h), with hardware counters
+// per operation where perf_event_open allows them. Every input is drawn
+// from a fixed seed so two runs time exactly the same work.
+// Exits with 2 when one of the ALLOCATION_FREE benchmarks touched the heap and
+// with 3 when a TRACKED benchmark regressed against the baseline or, unless
+// --filter left it out, is in the baseline but did not run.
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "Benchmark.h"
+#include "BenchmarkBaseline.h"
+#include "Player.h"
+using namespace std;
+
+const unsigned int BENCH_SEED = 2024;      //Seed of every generated input
+const int SAMPLE_COUNT = 1 << 16;          //Hands per sampled input set (power of 2)
+const int TURN_BATCH = 256;                //Players prepared per aiTurn batch
+
+//Benchmarks (by name prefix) that must not allocate at all
+const char* const ALLOCATION_FREE[] = {
+    "HandEvaluator::evaluate/", "BatchEvaluator::", "Deck::dealHands/", "PlayingHand::evaluateHand/", "PlayingHand::operator<",
+    "Player::findBestHand/", "Player::tryHandCombination/", "Player::aiTurn/"};
+
+//Benchmarks (by name prefix) that fail --compare when they get slower
+const char* const TRACKED[] = {
+    "PlayingHand::evaluateHand/all_five_card", "HandEvaluator::evaluate/", "BatchEvaluator::orderKeys/",
+    "Player::findBestHand/13_cards", "Player::aiTurn/"};
+
+bool isTracked(const string& name)
+{
+    for (const char* prefix : TRACKED)
+    {
+        if (name.rfind(prefix, 0) == 0) return true;
+    }
+    return false;
+}
+
+//Reaches the private steps of the AI
+class PlayerBenchmark
+{
+public:
+    static PlayingHand findBestHand(Player& player, const PlayingHand& hand)
+    {
+        return player.findBestHand(hand.getCardSet());
+    }
+    static PlayingHand tryHandCombination(Player& player, CardSet cards, int requiredType,
+                                          const PlayingHand& currentHand)
+    {
+        return player.tryHandCombination(cards, requiredType, currentHand);
+    }
+};
+
+//Reaches the private getHandCards of a hand
+class PlayingHandBenchmark
+{
+public:
+    static list<Card> getHandCards(const PlayingHand& hand)
+    {
+        return hand.getHandCards();
+    }
+};
+
+//Random set of cards of the given size
+CardSet randomCards(int size, mt19937_64& rng)
+{
+    int deck[52];
+    for (int i = 0; i < 52; i++) deck[i] = i;
+    CardSet cards;
+    for (int i = 0; i < size; i++)
+    {
+        uniform_int_distribution<int> pick(i, 51);
+        swap(deck[i], deck[pick(rng)]);
+        cards.addIndex(deck[i]);
+    }
+    return cards;
+}
+
+//Every five card hand of the deck (2,598,960 of them)
+vector<CardSet> allFiveCardHands()
+{
+    vector<CardSet> hands;
+    hands.reserve(2598960);
+    for (int a = 0; a < 52; a++)
+    for (int b = a + 1; b < 52; b++)
+    for (int c = b + 1; c < 52; c++)
+    for (int d = c + 1; d < 52; d++)
+    for (int e = d + 1; e < 52; e++)
+    {
+        hands.push_back(CardSet((1ULL << a) | (1ULL << b) | (1ULL << c) | (1ULL << d) | (1ULL << e)));
+    }
+    return hands;
+}
+
+//Deals the given cards to a quiet AI player
+void dealTo(Player& player, CardSet cards)
+{
+    player.clearCards();
+    for (const auto& card : cards)
+    {
+        player.addToPlayerHand(card);
+    }
+}
+
+//A random play of the cards that are not in the hand, for the AI to follow
+PlayingHand randomPlayAgainst(CardSet hand, mt19937_64& rng)
+{
+    MoveList moves;
+    uniform_int_distribution<int> size(1, 2);
+    MoveGenerator::generateOfSize(CardSet::fullDeck() - hand, size(rng), moves);
+    uniform_int_distribution<int> pick(0, moves.size() - 1);
+    PlayingHand play(moves[pick(rng)]);
+    play.evaluateHand();
+    return play;
+}
+
+int main(int argc, char* argv[])
+{
+    string filter;
+    double minSeconds = 0.5;
+    bool moveArena = true;
+    int repeats = 0;                //0 when not given
+    string savePath;
+    string comparePath;
+    double threshold = 5;           //Percent
+    double alpha = 0.05;
+    try {
+        for (int i = 1; i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) {
+                filter = argv[++i];
+            } else if (arg == "--min-time" && i + 1 < argc) {
+                minSeconds = stod(argv[++i]);
+            } else if (arg == "--allocator" && i + 1 < argc && (string(argv[i + 1]) == "arena" ||
+                                                                string(argv[i + 1]) == "default")) {
+                moveArena = string(argv[++i]) == "arena";
+            } else if (arg == "--repeat" && i + 1 < argc) {
+                repeats = stoi(argv[++i]);
+                if (repeats <= 0) throw invalid_argument(arg);
+            } else if (arg == "--save" && i + 1 < argc) {
+                savePath = argv[++i];
+            } else if (arg == "--compare" && i + 1 < argc) {
+                comparePath = argv[++i];
+            } else if (arg == "--threshold" && i + 1 < argc) {
+                threshold = stod(argv[++i]);
+            } else if (arg == "--alpha" && i + 1 < argc) {
+                alpha = stod(argv[++i]);
+            } else {
+                throw invalid_argument(arg);
+            }
+        }
+    } catch (const exception&) {
+        cerr << "Usage: " << argv[0] << " [--filter TEXT] [--min-time SECONDS] [--allocator arena|default]\n"
+             << "       [--repeat N] [--save FILE] [--compare FILE] [--threshold PERCENT] [--alpha P]" << endl;
+        return 1;
+    }
+    if (repeats == 0) {
+        // One timing per benchmark cannot tell a regression from noise
+        repeats = savePath.empty() && comparePath.empty() ? 1 : 5;
+    }
+    BenchmarkBaseline baseline;
+    if (!comparePath.empty()) {
+        // Read before hours of timing, not after
+        try {
+            baseline = loadBaseline(comparePath);
+        } catch (const runtime_error& error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner(minSeconds, filter, repeats);
+    mt19937_64 rng(BENCH_SEED);
+
+    //---INPUTS---
+    vector<PlayingHand> fiveCardHands;
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+    {
+        fiveCardHands.emplace_back(randomCards(5, rng));
+        fiveCardHands.back().evaluateHand();
+    }
+    vector<PlayingHand> thirteenCardHands;
+    for (int i = 0; i < 1024; i++)
+    {
+        thirteenCardHands.emplace_back(randomCards(13, rng));
+    }
+    // Candidates paired with a play of the same size from another hand
+    vector<pair<CardSet, PlayingHand>> combinations;
+    while (combinations.size() < 4096)
+    {
+        MoveList moves;
+        MoveGenerator::generate(randomCards(13, rng), moves);
+        MoveList others;
+        CardSet other = randomCards(13, rng);
+        CardSet candidate = moves[uniform_int_distribution<int>(0, moves.size() - 1)(rng)];
+        MoveGenerator::generateOfSize(other, candidate.size(), others);
+        if (others.empty()) continue;
+        PlayingHand current(others[uniform_int_distribution<int>(0, others.size() - 1)(rng)]);
+        current.evaluateHand();
+        combinations.emplace_back(candidate, current);
+    }
+
+    //---HAND EVALUATION---
+    if (runner.selected("PlayingHand::evaluateHand/all_five_card") ||
+        runner.selected("HandEvaluator::evaluate/all_five_card")) {
+        vector<CardSet> allHands = allFiveCardHands();
+        // A new hand every call: evaluateHand on an evaluated hand only checks its cache
+        runner.run("PlayingHand::evaluateHand/all_five_card", [&](long long i) {
+            PlayingHand hand(allHands[i % allHands.size()]);
+            hand.evaluateHand();
+            doNotOptimize(hand.getHandType());
+        });
+        runner.run("HandEvaluator::evaluate/all_five_card", [&](long long i) {
+            HandEvaluation eval = HandEvaluator::evaluate(allHands[i % allHands.size()]);
+            doNotOptimize(eval.handType);
+        });
+    }
+    // Every five card subset of a 13 card deal, the hand evaluation of a findBestHand
+    vector<uint64_t> subsets;
+    {
+        CardSet deal = thirteenCardHands[0].getCardSet();
+        for (uint64_t rest = deal.getMask(); rest != 0; rest &= rest - 1)
+        for (uint64_t b = rest & (rest - 1); b != 0; b &= b - 1)
+        for (uint64_t c = b & (b - 1); c != 0; c &= c - 1)
+        for (uint64_t d = c & (c - 1); d != 0; d &= d - 1)
+        for (uint64_t e = d & (d - 1); e != 0; e &= e - 1)
+        {
+            subsets.push_back((rest & (~rest + 1)) | (b & (~b + 1)) | (c & (~c + 1)) |
+                              (d & (~d + 1)) | (e & (~e + 1)));
+        }
+    }
+    vector<uint32_t> subsetKeys(subsets.size());
+    runner.run("BatchEvaluator::orderKeysScalar/1287_five_card_subsets", [&](long long) {
+        BatchEvaluator::orderKeysScalar(subsets.data(), static_cast<int>(subsets.size()), subsetKeys.data());
+        doNotOptimize(subsetKeys[0]);
+    });
+#if BATCH_EVALUATOR_AVX2
+    if (BatchEvaluator::hasSse42()) {
+        runner.run("BatchEvaluator::orderKeysSse42/1287_five_card_subsets", [&](long long) {
+            BatchEvaluator::orderKeysSse42(subsets.data(), static_cast<int>(subsets.size()), subsetKeys.data());
+            doNotOptimize(subsetKeys[0]);
+        });
+    }
+#endif
+    runner.run("BatchEvaluator::orderKeys/1287_five_card_subsets", [&](long long) {
+        BatchEvaluator::orderKeys(subsets.data(), static_cast<int>(subsets.size()), subsetKeys.data());
+        doNotOptimize(subsetKeys[0]);
+    });
+    runner.run("PlayingHand::operator</five_card", [&](long long i) {
+        bool less = fiveCardHands[i & (SAMPLE_COUNT - 1)] < fiveCardHands[(i * 7 + 1) & (SAMPLE_COUNT - 1)];
+        doNotOptimize(less);
+    });
+    runner.run("PlayingHand::getHandCards/five_card", [&](long long i) {
+        list<Card> cards = PlayingHandBenchmark::getHandCards(fiveCardHands[i & (SAMPLE_COUNT - 1)]);
+        doNotOptimize(cards.size());
+    });
+
+    //---DEALING---
+    Deck dealer;
+    dealer.fillDeck();
+    CardSet dealt[4];
+    runner.run("Deck::dealHands/4x13", [&](long long) {
+        dealer.dealHands(4, 13, dealt);
+        doNotOptimize(dealt[0]);
+    });
+    // The deal the simulator used before dealHands: refill, shuffle all 52 cards, take them one by one
+    runner.run("Deck::shuffleDeck/4x13_take_top", [&](long long i) {
+        dealer.fillDeck();
+        dealer.shuffleDeck(static_cast<unsigned int>(i));
+        for (int card = 0; card < 52; card++)
+        {
+            dealt[card & 3].add(dealer.takeTopFromDeck());
+        }
+        doNotOptimize(dealt[0]);
+    });
+
+    //---AI---
+    Player ai(true);
+    ai.setQuiet(true);
+    runner.run("Player::findBestHand/13_cards", [&](long long i) {
+        PlayingHand best = PlayerBenchmark::findBestHand(ai, thirteenCardHands[i & 1023]);
+        doNotOptimize(best.getHandType());
+    });
+    runner.run("Player::tryHandCombination/13_cards", [&](long long i) {
+        auto& input = combinations[i & 4095];
+        PlayingHand result = PlayerBenchmark::tryHandCombination(ai, input.first,
+            input.second.getHandType(), input.second);
+        doNotOptimize(result.size());
+    });
+
+    vector<Player> players(TURN_BATCH, Player(true));
+    vector<PlayingHand> toBeat(TURN_BATCH);
+    for (auto& player : players)
+    {
+        player.setQuiet(true);
+    }
+    // Each batched benchmark draws its deals from its own seed so --filter does not change them
+    mt19937_64 leadRng(BENCH_SEED + 1);
+    runner.runBatched("Player::aiTurn/lead_13_cards", TURN_BATCH,
+        [&](long long) {
+            for (auto& player : players) dealTo(player, randomCards(13, leadRng));
+        },
+        [&](long long i) {
+            players[i].aiTurn(PlayingHand());
+        });
+    mt19937_64 followRng(BENCH_SEED + 2);
+    runner.runBatched("Player::aiTurn/follow_13_cards", TURN_BATCH,
+        [&](long long) {
+            for (int i = 0; i < TURN_BATCH; i++)
+            {
+                CardSet hand = randomCards(13, followRng);
+                dealTo(players[i], hand);
+                toBeat[i] = randomPlayAgainst(hand, followRng);
+            }
+        },
+        [&](long long i) {
+            players[i].aiTurn(toBeat[i]);
+        });
+
+    // One opening move of the tree search AI, ns_per_op / 1000 is the cost of a playout
+    if (runner.selected("IsMctsSearch::chooseMove/lead_13_cards_1000_iterations")) {
+        MctsConfig config;
+        config.iterations = 1000;
+        config.moveArena = moveArena;
+        IsMctsSearch search(config);
+        TableView view;
+        for (int seat = 0; seat < GAME_SEATS; seat++) view.handSizes[seat] = 13;
+        runner.run("IsMctsSearch::chooseMove/lead_13_cards_1000_iterations", [&](long long i) {
+            CardSet move = search.chooseMove(thirteenCardHands[i & 1023].getCardSet(), CardSet(), view, i);
+            doNotOptimize(move);
+        });
+    }
+
+    // Fresh ten card endgames (3, 3, 2 and 2 cards) solved with the table kept between them
+    if (runner.selected("EndgameSolver::solve/10_cards")) {
+        EndgameSolver solver;
+        vector<GameState> endgames(TURN_BATCH);
+        mt19937_64 endgameRng(BENCH_SEED + 3);
+        const int sizes[GAME_SEATS] = {3, 3, 2, 2};
+        runner.runBatched("EndgameSolver::solve/10_cards", TURN_BATCH,
+            [&](long long) {
+                for (auto& state : endgames)
+                {
+                    CardSet left = randomCards(10, endgameRng);
+                    state = GameState();
+                    for (int seat = 0; seat < GAME_SEATS; seat++)
+                    {
+                        for (int i = 0; i < sizes[seat]; i++)
+                        {
+                            state.hands[seat].addIndex(left.lowestIndex());
+                            left.removeIndex(left.lowestIndex());
+                        }
+                    }
+                }
+            },
+            [&](long long i) {
+                doNotOptimize(solver.solve(endgames[i], 0));
+            });
+        const EndgameStats& stats = solver.getStats();
+        cerr << "EndgameSolver: " << stats.nodes << " nodes, tt hit rate "
+             << 100 * stats.hitRate() << "%" << endl;
+    }
+
+    int status = 0;
+    for (const auto& result : runner.getResults())
+    {
+        // The tree search only stays off the heap with its arena
+        bool allocationFree = moveArena && result.name.rfind("IsMctsSearch::", 0) == 0;
+        for (const char* prefix : ALLOCATION_FREE)
+        {
+            allocationFree = allocationFree || result.name.rfind(prefix, 0) == 0;
+        }
+        if (allocationFree && result.allocsPerOp > 0) {
+            cerr << result.name << " allocates " << result.allocsPerOp << " times per call" << endl;
+            status = 2;
+        }
+    }
+
+    if (!savePath.empty()) {
+        try {
+            saveBaseline(savePath, runner.getResults());
+        } catch (const runtime_error& error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+    }
+    if (!comparePath.empty()) {
+        for (const auto& comparison : compareToBaseline(runner.getResults(), baseline, threshold / 100, alpha))
+        {
+            bool tracked = isTracked(comparison.name);
+            cout << "{\"compare\":\"" << comparison.name << "\""
+                 << ",\"baseline_ns_per_op\":" << comparison.baselineNs
+                 << ",\"ns_per_op\":" << comparison.currentNs
+                 << ",\"change\":" << comparison.change
+                 << ",\"p\":" << comparison.p
+                 << ",\"tracked\":" << (tracked ? "true" : "false")
+                 << ",\"regressed\":" << (comparison.regressed ? "true" : "false") << "}" << endl;
+            if (tracked && comparison.regressed) {
+                cerr << comparison.name << " is " << 100 * comparison.change << "% slower than the baseline (p = "
+                     << comparison.p << ")" << endl;
+                status = status == 0 ? 3 : status;
+            }
+        }
+        // A renamed or removed benchmark must not slip out of the comparison unnoticed
+        for (const auto& result : runner.getResults())
+        {
+            if (isTracked(result.name) && baseline.count(result.name) == 0) {
+                cerr << result.name << " is tracked but not in " << comparePath << ", save a new baseline" << endl;
+            }
+        }
+        for (const auto& saved : baseline)
+        {
+            if (!isTracked(saved.first)) continue;
+            bool ran = false;
+            for (const auto& result : runner.getResults())
+            {
+                ran = ran || result.name == saved.first;
+            }
+            if (ran) continue;
+            if (!runner.selected(saved.first)) {
+                cerr << saved.first << " is tracked but left out by --filter, not compared" << endl;
+            } else {
+                // Selected but gone: it was renamed or deleted, so nothing guards it any more
+                cerr << saved.first << " is tracked in " << comparePath << " but did not run" << endl;
+                status = status == 0 ? 3 : status;
+            }
+        }
+    }
+    return status;
+}
@@ -3,28 +3,18 @@
 #include "Deck.h"
 #include "PlayingHand.h"
 #include "Player.h"
-#include <stack>
-#include <queue>
+#include "GameEngine.h"
+#include "Trace.h"
 #include <random>
 #include <numeric>
 #include <algorithm>
 #include <limits>
+#include <stdexcept>
 using namespace std;
 
-// Function to find player with three of clubs
-Player* findFirstPlayer(Player* players[], int numPlayers) {
-    for (int i = 0; i < numPlayers; i++) {
-        for (const auto& card : players[i]->getPlayerDeck().getCards()) {
-            if (card.getCard() == 1 && card.getSuit() == 1) {  // 3 of clubs
-                return players[i];
-            }
-        }
-    }
-    return nullptr;
-}
-
 // Function to display all players' card counts
 void displayCardCounts(Player* players[], int numPlayers) {
+    TRACE_SCOPE("render");
     cout << "\n=== Card Counts ===" << endl;
     for (int i = 0; i < numPlayers; i++) {
         cout << "Player " << (i + 1) << ": " << players[i]->getAmountOfCards() << " cards" << endl;
@@ -32,9 +22,54 @@ void displayCardCounts(Player* players[], int numPlayers) {
     cout << "=================" << endl;
 }
 
-int main()
+int main(int argc, char* argv[])
 {
     const int amountOfPlayers = 4;
+
+    // Every shuffle and AI search of the game comes from this seed, pass it back in to replay the game
+    uint64_t seed = 0;
+    bool seedGiven = false;
+    string tracePath;           //--trace FILE writes a timeline of the game (builds with BIG2_TRACE)
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--trace") {
+                if (i + 1 >= argc) throw invalid_argument(arg);
+                tracePath = argv[++i];
+            } else {
+                // The whole argument has to be one unsigned number
+                size_t used = 0;
+                if (seedGiven || arg.empty() || arg[0] == '-') throw invalid_argument(arg);
+                seed = stoull(arg, &used);
+                if (used != arg.size()) throw invalid_argument(arg);
+                seedGiven = true;
+            }
+        }
+    } catch (const exception&) {
+        cout << "Usage: " << argv[0] << " [seed] [--trace FILE]" << endl;
+        return 1;
+    }
+    if (!seedGiven) {
+        random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+#if BIG2_TRACE
+    if (!tracePath.empty()) {
+        try {
+            Tracer::start(tracePath);
+        } catch (const runtime_error& error) {
+            cout << "Error: " << error.what() << endl;
+            return 1;
+        }
+    }
+#else
+    if (!tracePath.empty()) {
+        cout << "Error: this build cannot trace (build with -DBIG2_TRACE=1)" << endl;
+        return 1;
+    }
+#endif
+    cout << "Game seed: " << seed << " (run " << argv[0] << " " << seed << " to replay this deal)" << endl;
+
     Deck* TestDeck = new Deck(52);
     Player* TestPlayer = new Player();
     Player* AI1 = new Player(true);  // Set as AI
@@ -44,110 +79,99 @@ int main()
     // Array of players for easier iteration
     Player* players[amountOfPlayers] = {TestPlayer, AI1, AI2, AI3};
 
-    // Stack to keep track of previous hands
-    stack<PlayingHand> handHistory;
-    
-    // Queue to manage turn order
-    queue<Player*> turnOrder;
-
     // Deal cards
+    TestDeck->seed(seed, gameStream(0, STREAM_DEAL));
     TestDeck->shuffleDeck();
+    for (int i = 0; i < amountOfPlayers; i++) {
+        players[i]->seedAi(seed, gameStream(0, STREAM_SEAT + i));
+    }
     
     // Deal cards directly from the shuffled deck
     for(int i = 0; i < 13; i++) {
         for(int j = 0; j < amountOfPlayers; j++) {
-            if(!TestDeck->getCards().empty()) {
+            if(!TestDeck->empty()) {
                 Card dealtCard = TestDeck->takeTopFromDeck();
                 players[j]->addToPlayerHand(dealtCard);
             }
         }
     }
 
-    // Find player with three of clubs and set up turn order
-    Player* firstPlayer = findFirstPlayer(players, amountOfPlayers);
-    if (!firstPlayer) {
+    // The player with three of clubs starts, then the others take turns by
+    // player number. The engine hands the turn on to seat + 1, so the players
+    // sit down in that order: seat k is played by players[turnOrder[k]]
+    int turnOrder[amountOfPlayers];
+    int seated = 0;
+    for (int i = 0; i < amountOfPlayers; i++) {
+        if (players[i]->getPlayerDeck().getCardSet().containsIndex(0)) {
+            turnOrder[seated++] = i;
+        }
+    }
+    if (seated == 0) {
         cout << "Error: No player has the three of clubs!" << endl;
         return 1;
     }
-
-    // Set up turn order starting with player who has three of clubs
-    turnOrder.push(firstPlayer);
     for (int i = 0; i < amountOfPlayers; i++) {
-        if (players[i] != firstPlayer) {
-            turnOrder.push(players[i]);
+        if (i != turnOrder[0]) {
+            turnOrder[seated++] = i;
         }
     }
 
+    // The engine keeps the turn order, the hand to beat and the passes from here on
+    CardSet hands[amountOfPlayers];
+    for (int seat = 0; seat < amountOfPlayers; seat++) {
+        hands[seat] = players[turnOrder[seat]]->getPlayerDeck().getCardSet();
+    }
+    GameState state = GameEngine::newGame(hands);
+
     // Display initial card counts
     displayCardCounts(players, amountOfPlayers);
 
     // Game loop
-    bool gameOver = false;
-    int consecutivePasses = 0;
-    Player* lastPlayer = nullptr;  // Track who played the last hand
-
-    while (!gameOver) {
-        Player* currentPlayer = turnOrder.front();
-        cout << "\n=== Player " << (currentPlayer == TestPlayer ? "1" : 
-                                  currentPlayer == AI1 ? "2" : 
-                                  currentPlayer == AI2 ? "3" : "4") << "'s Turn ===" << endl;
-        
-        // Get the current hand to beat (if any)
-        PlayingHand currentHand;
-        if (!handHistory.empty()) {
-            currentHand = handHistory.top();
-        }
+    TRACE_PHASE(gameSpan, "game");
+    while (!GameEngine::isTerminal(state)) {
+        LATENCY_SCOPE(LatencyProbe::Turn);
+        int player = turnOrder[state.seat];
+        TRACE_SCOPE_ARG("turn", "player", player);
+        cout << "\n=== Player " << (player + 1) << "'s Turn ===" << endl;
 
-        // Player takes their turn
-        PlayingHand playedHand = currentPlayer->decision(currentHand);
+        // Player takes their turn against the current hand to beat (if any)
+        PlayingHand playedHand = players[player]->decision(PlayingHand(state.top), GameEngine::viewFor(state));
 
         // Check if player passed
-        if (playedHand.getCards().empty()) {
-            cout << "Player " << (currentPlayer == TestPlayer ? "1" : 
-                                currentPlayer == AI1 ? "2" : 
-                                currentPlayer == AI2 ? "3" : "4") << " passes" << endl;
-            consecutivePasses++;
-            // Move player to back of queue
-            turnOrder.pop();
-            turnOrder.push(currentPlayer);
-        } else {
-            // Player played a hand
-            handHistory.push(playedHand);
-            consecutivePasses = 0;
-            lastPlayer = currentPlayer;
-            // Move player to back of queue
-            turnOrder.pop();
-            turnOrder.push(currentPlayer);
+        bool roundOpen = !state.top.empty();
+        if (playedHand.empty()) {
+            cout << "Player " << (player + 1) << " passes" << endl;
         }
+        GameEngine::apply(state, playedHand.getCardSet());
 
         // Display updated card counts after each turn
         displayCardCounts(players, amountOfPlayers);
 
         // Check for game over conditions
-        if (currentPlayer->getAmountOfCards() == 0) {
-            cout << "\nPlayer " << (currentPlayer == TestPlayer ? "1" : 
-                                  currentPlayer == AI1 ? "2" : 
-                                  currentPlayer == AI2 ? "3" : "4") << " wins!" << endl;
-            gameOver = true;
+        if (GameEngine::isTerminal(state)) {
+            cout << "\nPlayer " << (player + 1) << " wins!" << endl;
             continue;
         }
 
-        // Check if we should start a new round (3 consecutive passes)
-        if (consecutivePasses >= 3) {
+        // Three consecutive passes start a new round led by the last player to play
+        if (playedHand.empty() && roundOpen && state.top.empty()) {
             cout << "\n=== New Round ===" << endl;
-            handHistory = stack<PlayingHand>();  // Clear the hand history
-            consecutivePasses = 0;
-            
-            // If someone played a hand, they start the next round
-            if (lastPlayer) {
-                // Reorder queue to start with last player
-                while (turnOrder.front() != lastPlayer) {
-                    turnOrder.push(turnOrder.front());
-                    turnOrder.pop();
-                }
-            }
         }
     }
+    TRACE_END(gameSpan);
+#if BIG2_TRACE
+    if (!tracePath.empty()) {
+        try {
+            Tracer::stop();
+            cout << "Trace written to " << tracePath << endl;
+        } catch (const runtime_error& error) {
+            cout << "Error: " << error.what() << endl;
+        }
+    }
+#endif
+
+    // Turn timings of the game (only in builds with BIG2_LATENCY)
+    printLatencyReport(cout);
 
     // Cleanup
     delete TestDeck;
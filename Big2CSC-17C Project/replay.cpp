@@ -0,0 +1,112 @@
+// big2_replay - checks the games of a record file (big2_sim --record) against the rules
+// Usage: big2_replay FILE [--threads N]
+//   --threads N         replay on N threads (default: every hardware thread)
+// Exits with status 1 if a game breaks the rules or its recorded winner is wrong.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "PlayingHand.h"
+#include "RecordReplay.h"
+#include "Tournament.h"
+using namespace std;
+
+void printUsage(const char* program)
+{
+    cerr << "Usage: " << program << " FILE [--threads N]" << endl;
+}
+
+//Share of part in whole, in percent
+double percent(long long part, long long whole)
+{
+    return whole > 0 ? 100.0 * part / whole : 0;
+}
+
+void printResult(const ReplayResult& result, const GameRecordFile& file)
+{
+    const ReplayStats& stats = result.stats;
+    cout << fixed << setprecision(2);
+    cout << "games: " << stats.games << '\n';
+    cout << "seed: " << file.getSeed() << '\n';
+    cout << "threads: " << result.threads << '\n';
+    cout << "bad deals: " << stats.badDeals << '\n';
+    cout << "illegal moves: " << stats.illegalMoves << '\n';
+    cout << "wrong winners: " << stats.wrongWinners << '\n';
+    cout << "malformed games: " << stats.malformed << '\n';
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        cout << "seat " << (seat + 1) << " wins: " << stats.wins[seat]
+             << " (" << percent(stats.wins[seat], stats.games) << "%)\n";
+    }
+    if (stats.unfinished > 0) {
+        cout << "unfinished: " << stats.unfinished << '\n';
+    }
+    cout << "average turns: " << (stats.games > 0 ? static_cast<double>(stats.turns) / stats.games : 0) << '\n';
+    cout << "plays: " << stats.plays << " (leads: " << stats.leads << ", average cards: "
+         << (stats.plays > 0 ? static_cast<double>(stats.cardsPlayed) / stats.plays : 0) << ")\n";
+    for (int type = 1; type < REPLAY_HAND_TYPES; type++)
+    {
+        if (stats.playsByType[type] > 0) {
+            cout << "  " << PlayingHand::handTypeName(type) << ": " << stats.playsByType[type]
+                 << " (" << percent(stats.playsByType[type], stats.plays) << "%)\n";
+        }
+    }
+    long long withBeat = 0;
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        withBeat += stats.passesWithBeat[seat];
+    }
+    cout << "passes: " << stats.passes << '\n';
+    cout << "passes holding a beating play: " << withBeat
+         << " (" << percent(withBeat, stats.passes) << "%)\n";
+    for (int seat = 0; seat < GAME_SEATS; seat++)
+    {
+        cout << "  seat " << (seat + 1) << ": " << stats.passesWithBeat[seat] << '\n';
+    }
+    cout << "passes where shouldPass says pass: " << stats.rulePasses
+         << " (holding a beating play: " << stats.rulePassesWithBeat << ")\n";
+    cout << "seconds: " << result.seconds << '\n';
+    cout << "games/sec: " << result.gamesPerSecond() << '\n';
+    cout << "MB/sec: " << result.megabytesPerSecond() << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+    string path;
+    int threads = hardwareThreads();
+
+    try {
+        for (int i = 1; i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                threads = stoi(argv[++i]);
+            } else if (path.empty()) {
+                path = arg;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (path.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (threads <= 0) {
+        cerr << "The thread count must be positive" << endl;
+        return 1;
+    }
+
+    try {
+        GameRecordFile file(path);
+        ReplayResult result = replayRecords(file, threads);
+        printResult(result, file);
+        return result.stats.errors() > 0 ? 1 : 0;
+    } catch (const runtime_error& error) {
+        cerr << error.what() << endl;
+        return 1;
+    }
+}
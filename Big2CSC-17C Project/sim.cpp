@@ -0,0 +1,192 @@
+// big2_sim - plays many AI only games without any console output
+// Usage: big2_sim [games] [seed] [--threads N] [--scaling] [--mcts SEAT ...]
+//   --threads N         play on N threads (default: every hardware thread)
+//   --scaling           run the same games on 1, 2, 4 ... N threads and report games/sec for each
+//   --mcts SEAT         seat (1-4) played by the tree search AI instead of the heuristic, repeatable
+//   --iterations N      playouts per tree search move (default 2000)
+//   --move-ms MS        time per tree search move, without --iterations it is the only limit
+//   --search-threads N  trees grown at once per tree search move (root parallelism)
+//   --endgame N         solve the game exactly once N or fewer cards are left (default 10, 0 = off)
+//   --record FILE       write every game to FILE in the binary record format (see GameRecord.h)
+//   --trace FILE        write a Chrome trace of every game, turn and AI phase to FILE (builds with -DBIG2_TRACE=1)
+// Built with -DBIG2_LATENCY=1 it also prints latency percentiles of turns and AI steps (see Latency.h).
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "Tournament.h"
+using namespace std;
+
+void printUsage(const char* program)
+{
+    cerr << "Usage: " << program << " [games] [seed] [--threads N] [--scaling]"
+         << " [--mcts SEAT] [--iterations N] [--move-ms MS] [--search-threads N] [--endgame N]"
+         << " [--record FILE] [--trace FILE]" << endl;
+}
+
+void printResult(const TournamentResult& result, uint64_t seed, const TableSetup& setup)
+{
+    const SimulationStats& stats = result.stats;
+    cout << fixed << setprecision(2);
+    cout << "games: " << stats.games << '\n';
+    cout << "seed: " << seed << '\n';
+    cout << "threads: " << result.threads << '\n';
+    for (int i = 0; i < SIM_PLAYERS; i++)
+    {
+        cout << "seat " << (i + 1) << (setup.modes[i] == AiMode::Mcts ? " (mcts)" : "")
+             << " wins: " << stats.wins[i]
+             << " (" << 100.0 * stats.wins[i] / stats.games << "%)\n";
+    }
+    if (stats.unfinished > 0) {
+        cout << "unfinished: " << stats.unfinished << '\n';
+    }
+    cout << "average turns: " << static_cast<double>(stats.turns) / stats.games << '\n';
+    const EndgameStats& endgame = result.endgame;
+    if (setup.endgame.cardThreshold > 0) {
+        cout << "endgame moves: " << endgame.moves << " (handed back: " << endgame.gaveUp << ")\n";
+        cout << "endgame nodes/sec: " << endgame.nodesPerSecond() << '\n';
+        cout << "endgame tt hit rate: " << 100 * endgame.hitRate() << "%\n";
+    }
+    cout << "seconds: " << result.seconds << '\n';
+    cout << "games/sec: " << result.gamesPerSecond() << '\n';
+    // Every thread's turn and AI timings (only in builds with BIG2_LATENCY)
+    printLatencyReport(cout);
+}
+
+//Closes the trace of --trace, returns the exit status
+int finishTrace(const string& tracePath)
+{
+#if BIG2_TRACE
+    if (tracePath.empty()) {
+        return 0;
+    }
+    try {
+        unsigned long long dropped = Tracer::stop();
+        cout << "trace: " << tracePath << " (" << dropped << " spans dropped)\n";
+    } catch (const runtime_error& error) {
+        cerr << error.what() << endl;
+        return 1;
+    }
+#else
+    (void)tracePath;
+#endif
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    long long games = 1000;
+    uint64_t seed = 1;
+    int threads = hardwareThreads();
+    bool scaling = false;
+    TableSetup setup;
+    bool iterationsGiven = false;
+    string recordPath;
+    string tracePath;
+
+    try {
+        int position = 0;
+        for (int i = 1; i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                threads = stoi(argv[++i]);
+            } else if (arg == "--scaling") {
+                scaling = true;
+            } else if (arg == "--mcts" && i + 1 < argc) {
+                int seat = stoi(argv[++i]);
+                if (seat < 1 || seat > SIM_PLAYERS) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+                setup.modes[seat - 1] = AiMode::Mcts;
+            } else if (arg == "--iterations" && i + 1 < argc) {
+                setup.mcts.iterations = stoi(argv[++i]);
+                iterationsGiven = true;
+            } else if (arg == "--move-ms" && i + 1 < argc) {
+                setup.mcts.seconds = stod(argv[++i]) / 1000;
+                if (!iterationsGiven) setup.mcts.iterations = 0;
+            } else if (arg == "--endgame" && i + 1 < argc) {
+                setup.endgame.cardThreshold = stoi(argv[++i]);
+            } else if (arg == "--record" && i + 1 < argc) {
+                recordPath = argv[++i];
+            } else if (arg == "--trace" && i + 1 < argc) {
+                tracePath = argv[++i];
+            } else if (arg == "--search-threads" && i + 1 < argc) {
+                setup.mcts.threads = stoi(argv[++i]);
+            } else if (position == 0) {
+                games = stoll(arg);
+                position++;
+            } else if (position == 1) {
+                seed = stoull(arg);
+                position++;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (games <= 0 || threads <= 0 || setup.mcts.threads <= 0) {
+        cerr << "The game and thread counts must be positive" << endl;
+        return 1;
+    }
+    if (setup.mcts.iterations <= 0 && setup.mcts.seconds <= 0) {
+        cerr << "The tree search needs a positive --iterations or --move-ms" << endl;
+        return 1;
+    }
+
+    if (scaling && (!recordPath.empty() || !tracePath.empty())) {
+        cerr << "--record and --trace cannot be combined with --scaling" << endl;
+        return 1;
+    }
+#if BIG2_TRACE
+    if (!tracePath.empty()) {
+        try {
+            Tracer::start(tracePath);
+        } catch (const runtime_error& error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+    }
+#else
+    if (!tracePath.empty()) {
+        cerr << "This build cannot trace, build it with -DBIG2_TRACE=1" << endl;
+        return 1;
+    }
+#endif
+
+    if (!scaling) {
+        if (recordPath.empty()) {
+            printResult(runTournament(games, seed, threads, setup), seed, setup);
+            return finishTrace(tracePath);
+        }
+        try {
+            GameRecordWriter records(recordPath, seed);
+            printResult(runTournament(games, seed, threads, setup, &records), seed, setup);
+            records.close();
+            cout << "records: " << recordPath << " (" << records.bytes() << " bytes, "
+                 << static_cast<double>(records.bytes()) / games << " per game)\n";
+        } catch (const runtime_error& error) {
+            cerr << error.what() << endl;
+            return 1;
+        }
+        return finishTrace(tracePath);
+    }
+
+    // Same games on more and more threads, the totals must not change
+    cout << fixed << setprecision(2);
+    cout << "threads,games,seconds,games_per_sec,speedup\n";
+    double singleThread = 0;
+    for (int count = 1; ; count *= 2)
+    {
+        if (count > threads) count = threads;
+        TournamentResult result = runTournament(games, seed, count, setup);
+        if (count == 1) singleThread = result.gamesPerSecond();
+        cout << result.threads << ',' << result.stats.games << ',' << result.seconds << ','
+             << result.gamesPerSecond() << ',' << result.gamesPerSecond() / singleThread << '\n';
+        if (count == threads) break;
+    }
+    return 0;
+}